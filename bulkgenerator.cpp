@@ -0,0 +1,176 @@
+#include "bulkgenerator.h"
+#include "mazearchive.h"
+#include "mazearena.h"
+#include "mazeutil.h"
+#include "tracer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+long long elapsedNs(Clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count();
+}
+
+// Encoded records for maze indices [first, first + ends.size())
+struct Chunk {
+    std::string bytes;
+    std::vector<size_t> ends;   // end offset of each record in bytes
+};
+
+// Hand-off between workers and the writer. Chunks arrive in any order and
+// leave in index order; workers wait while they are too far ahead.
+struct Pipeline {
+    std::mutex mutex;
+    std::condition_variable chunkReady;
+    std::condition_variable chunkWritten;
+    std::map<long long, Chunk> pending;
+    long long nextToWrite = 0;
+    long long window = 0;
+    bool failed = false;
+};
+
+} // namespace
+
+bool BulkGenerator::run(const std::string& outputPrefix, BulkStats& stats) {
+    stats = BulkStats();
+    if (options.count < 0 || options.width < 1 || options.height < 1) {
+        error = "count must be non-negative and width/height positive";
+        return false;
+    }
+    if (static_cast<long long>(options.width) * options.height > INT_MAX) {
+        error = "width times height must be at most " + std::to_string(INT_MAX) + " cells";
+        return false;
+    }
+
+    int threadCount = resolveThreads(options.threads);
+    long long chunkSize = std::max(options.chunkSize, 1);
+    long long chunkCount = (options.count + chunkSize - 1) / chunkSize;
+
+    Pipeline pipeline;
+    pipeline.window = static_cast<long long>(threadCount) * 4;
+    std::atomic<long long> nextChunk{0};
+    std::atomic<long long> generateNs{0}, solveNs{0}, encodeNs{0};
+
+    auto worker = [&]() {
+        Maze maze(options.width, options.height);
+        MazeArena arena;
+        long long generateTotal = 0, solveTotal = 0, encodeTotal = 0;
+
+        for (;;) {
+            long long chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunkCount) break;
+
+            {
+                // Backpressure: stay within the writer's window
+                std::unique_lock<std::mutex> lock(pipeline.mutex);
+                pipeline.chunkWritten.wait(lock, [&] {
+                    return pipeline.failed || chunk < pipeline.nextToWrite + pipeline.window;
+                });
+                if (pipeline.failed) break;
+            }
+
+            TRACE_SCOPE("bulk", "chunk");
+            Chunk out;
+            long long first = chunk * chunkSize;
+            long long last = std::min(first + chunkSize, options.count);
+            for (long long index = first; index < last; index++) {
+                arena.reset();
+
+                auto start = Clock::now();
+                maze.generateMaze(options.cycles, options.seed, static_cast<uint64_t>(index), arena.resource());
+                generateTotal += elapsedNs(start);
+
+                PathResult solution(arena.resource());
+                if (options.solve) {
+                    start = Clock::now();
+                    PathFinder pf(&maze, 0, 0, options.width - 1, options.height - 1);
+                    pf.setScratchResource(arena.resource());
+                    pf.setResultResource(arena.resource());
+                    solution = pf.solve(options.algorithm);
+                    solveTotal += elapsedNs(start);
+                }
+
+                start = Clock::now();
+                encodeArchiveRecord(out.bytes, static_cast<uint64_t>(index), maze, options.cycles,
+                                    options.solve ? &solution : nullptr);
+                out.ends.push_back(out.bytes.size());
+                encodeTotal += elapsedNs(start);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(pipeline.mutex);
+                pipeline.pending.emplace(chunk, std::move(out));
+            }
+            pipeline.chunkReady.notify_one();
+        }
+
+        generateNs.fetch_add(generateTotal, std::memory_order_relaxed);
+        solveNs.fetch_add(solveTotal, std::memory_order_relaxed);
+        encodeNs.fetch_add(encodeTotal, std::memory_order_relaxed);
+    };
+
+    MazeArchiveWriter writer(outputPrefix, options.shardSize);
+    auto start = Clock::now();
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(worker);
+    }
+
+    // This thread is the writer
+    bool ok = true;
+    for (long long chunk = 0; chunk < chunkCount && ok; chunk++) {
+        Chunk next;
+        {
+            std::unique_lock<std::mutex> lock(pipeline.mutex);
+            pipeline.chunkReady.wait(lock, [&] { return pipeline.pending.count(chunk) != 0; });
+            next = std::move(pipeline.pending[chunk]);
+            pipeline.pending.erase(chunk);
+        }
+
+        TRACE_SCOPE("bulk", "write chunk");
+        size_t begin = 0;
+        for (size_t end : next.ends) {
+            if (!writer.append(next.bytes.data() + begin, end - begin)) {
+                ok = false;
+                break;
+            }
+            begin = end;
+            stats.mazes++;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(pipeline.mutex);
+            pipeline.nextToWrite = chunk + 1;
+            pipeline.failed = !ok;
+        }
+        pipeline.chunkWritten.notify_all();
+    }
+
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    if (ok && !writer.close()) ok = false;
+    if (!ok) error = writer.lastError();
+
+    stats.elapsedNs = elapsedNs(start);
+    stats.bytes = writer.bytesWritten();
+    stats.shards = writer.shardCount();
+    stats.threads = threadCount;
+    stats.generateNs = generateNs.load();
+    stats.solveNs = solveNs.load();
+    stats.encodeNs = encodeNs.load();
+    stats.mazesPerSecond = stats.elapsedNs > 0 ? stats.mazes * 1e9 / stats.elapsedNs : 0.0;
+    return ok;
+}
@@ -0,0 +1,52 @@
+#ifndef BULKGENERATOR_H
+#define BULKGENERATOR_H
+
+#include <string>
+#include "pathfinder.h"
+
+struct BulkOptions {
+    long long count = 1000;
+    int width = 32;
+    int height = 32;
+    int cycles = 0;             // extra walls removed per maze
+    unsigned int seed = 0;      // maze i uses stream i of this seed
+    bool solve = false;         // store a corner-to-corner solution per maze
+    Algorithm algorithm = Algorithm::BFS;
+    int threads = 0;            // 0 = one per hardware thread
+    long long shardSize = 10000;  // mazes per archive shard
+    int chunkSize = 64;         // mazes a worker claims at a time
+};
+
+struct BulkStats {
+    long long mazes = 0;
+    long long bytes = 0;
+    int shards = 0;
+    int threads = 0;
+    long long elapsedNs = 0;    // wall time, start of the first worker to last write
+    long long generateNs = 0;   // summed over workers
+    long long solveNs = 0;      // summed over workers
+    long long encodeNs = 0;     // summed over workers
+    double mazesPerSecond = 0.0;
+};
+
+// Produces N independent mazes across all cores and streams them into a
+// sharded MazeArchive. Workers claim chunks of consecutive maze indices and
+// encode them with per-thread arenas; a single writer thread reorders the
+// chunks and appends them, so the archive bytes depend only on the options,
+// never on the thread count or scheduling. At most a few chunks per worker
+// are in flight, which bounds memory however large the batch.
+class BulkGenerator {
+private:
+    BulkOptions options;
+    std::string error;
+
+public:
+    explicit BulkGenerator(const BulkOptions& o) : options(o) {}
+
+    // Writes PREFIX-00000.mzar, PREFIX-00001.mzar, ...; false on I/O errors
+    bool run(const std::string& outputPrefix, BulkStats& stats);
+
+    const std::string& lastError() const { return error; }
+};
+
+#endif // BULKGENERATOR_H
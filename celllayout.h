@@ -0,0 +1,110 @@
+#ifndef CELLLAYOUT_H
+#define CELLLAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Order in which per-cell traversal state (union-find parents, visited
+// flags, distances, mirrored wall masks) is laid out in memory.
+//   RowMajor: y * width + x, the order of Maze::wallMasks().
+//   Morton:   64 x 64 tiles in row-major order, Z-order inside each tile,
+//             so a step in any direction usually stays within a few
+//             cache lines and almost always within the tile's pages.
+//   Blocked:  the same tiles, row-major inside each tile.
+// The tiled layouts pad the maze to whole tiles, so size() can exceed
+// width * height; padding slots are never visited.
+enum class CellLayoutKind { RowMajor, Morton, Blocked };
+
+class CellLayout {
+public:
+    static constexpr int TileShift = 6;
+    static constexpr int TileSide = 1 << TileShift;
+    static constexpr size_t TileCells = static_cast<size_t>(TileSide) * TileSide;
+
+private:
+    CellLayoutKind kind;
+    int width, height;
+    int tilesAcross, tilesDown;
+
+    // Bits 0..15 of v moved to the even bit positions, and back
+    static uint32_t spread(uint32_t v) {
+        v &= 0xffff;
+        v = (v | (v << 8)) & 0x00ff00ff;
+        v = (v | (v << 4)) & 0x0f0f0f0f;
+        v = (v | (v << 2)) & 0x33333333;
+        return (v | (v << 1)) & 0x55555555;
+    }
+    static uint32_t compact(uint32_t v) {
+        v &= 0x55555555;
+        v = (v | (v >> 1)) & 0x33333333;
+        v = (v | (v >> 2)) & 0x0f0f0f0f;
+        v = (v | (v >> 4)) & 0x00ff00ff;
+        return (v | (v >> 8)) & 0xffff;
+    }
+
+public:
+    explicit CellLayout(CellLayoutKind kind = CellLayoutKind::RowMajor, int width = 0, int height = 0)
+        : kind(kind), width(width), height(height),
+          tilesAcross((width + TileSide - 1) >> TileShift),
+          tilesDown((height + TileSide - 1) >> TileShift) {}
+
+    CellLayoutKind getKind() const { return kind; }
+    bool isRowMajor() const { return kind == CellLayoutKind::RowMajor; }
+
+    // Slots an array in this layout needs
+    size_t size() const {
+        if (isRowMajor()) return static_cast<size_t>(width) * height;
+        return static_cast<size_t>(tilesAcross) * tilesDown * TileCells;
+    }
+
+    size_t index(int x, int y) const {
+        if (isRowMajor()) return static_cast<size_t>(y) * width + x;
+        size_t tile = static_cast<size_t>(y >> TileShift) * tilesAcross + (x >> TileShift);
+        uint32_t ix = x & (TileSide - 1), iy = y & (TileSide - 1);
+        uint32_t inner = kind == CellLayoutKind::Morton ? spread(ix) | spread(iy) << 1
+                                                        : iy << TileShift | ix;
+        return tile * TileCells + inner;
+    }
+
+    void coords(size_t index, int& x, int& y) const {
+        if (isRowMajor()) {
+            x = static_cast<int>(index % width);
+            y = static_cast<int>(index / width);
+            return;
+        }
+        size_t tile = index >> (2 * TileShift);
+        uint32_t inner = static_cast<uint32_t>(index & (TileCells - 1));
+        int ix, iy;
+        if (kind == CellLayoutKind::Morton) {
+            ix = static_cast<int>(compact(inner));
+            iy = static_cast<int>(compact(inner >> 1));
+        } else {
+            ix = static_cast<int>(inner & (TileSide - 1));
+            iy = static_cast<int>(inner >> TileShift);
+        }
+        x = static_cast<int>(tile % tilesAcross) << TileShift | ix;
+        y = static_cast<int>(tile / tilesAcross) << TileShift | iy;
+    }
+
+    static const char* name(CellLayoutKind kind) {
+        switch (kind) {
+            case CellLayoutKind::RowMajor: return "row";
+            case CellLayoutKind::Morton: return "morton";
+            case CellLayoutKind::Blocked: return "blocked";
+        }
+        return "row";
+    }
+
+    static bool parse(const std::string& text, CellLayoutKind& out) {
+        for (CellLayoutKind kind : {CellLayoutKind::RowMajor, CellLayoutKind::Morton, CellLayoutKind::Blocked}) {
+            if (text == name(kind)) {
+                out = kind;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif // CELLLAYOUT_H
@@ -1,11 +1,26 @@
 #include <QApplication>
+#include <cstdlib>
+#include <iostream>
 #include "mainwindow.h"
+#include "tracer.h"
 
 int main(int argc, char* argv[]) {
     QApplication app(argc, argv);
     
+    // MAZE_TRACE=file.json records a timeline until the window closes
+    const char* tracePath = std::getenv("MAZE_TRACE");
+    if (tracePath && *tracePath) {
+        Tracer::setEnabled(true);
+    }
+    
     MainWindow window;
     window.show();
     
-    return app.exec();
-}
\ No newline at end of file
+    int status = app.exec();
+    
+    std::string error;
+    if (tracePath && *tracePath && !Tracer::writeChromeJson(tracePath, &error)) {
+        std::cerr << error << "\n";
+    }
+    return status;
+}
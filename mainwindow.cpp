@@ -5,12 +5,28 @@
 #include <QGroupBox>
 #include <QLabel>
 #include <QFont>
+#include <QFileDialog>
+#include <QSignalBlocker>
 #include <QMessageBox>
-#include <QElapsedTimer>
+#include <QHeaderView>
+#include "memorytracker.h"
+
+// Human-readable duration from nanoseconds
+static QString formatNs(long long ns) {
+    if (ns < 10000) return QString("%1 ns").arg(ns);
+    if (ns < 10000000) return QString("%1 us").arg(ns / 1000.0, 0, 'f', 1);
+    return QString("%1 ms").arg(ns / 1000000.0, 0, 'f', 2);
+}
+
+static QString formatBytes(long long bytes) {
+    if (bytes < 10 * 1024) return QString("%1 B").arg(bytes);
+    if (bytes < 10 * 1024 * 1024) return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+    return QString("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+}
 
 MainWindow::MainWindow(QWidget* parent)
-    : QMainWindow(parent), mazeWidth(15), mazeHeight(15), 
-      bfsSteps(0), dfsSteps(0), bfsTime(0), dfsTime(0) {
+    : QMainWindow(parent), memoryLabel(nullptr), mazeWidth(15), mazeHeight(15), 
+      bfsSteps(0), dfsSteps(0) {
     
     setupUI();
     connectSignals();
@@ -150,6 +166,23 @@ void MainWindow::setupUI() {
     );
     solveLayout->addWidget(dfsBtn);
     
+    raceBtn = new QPushButton("Race All Solvers");
+    raceBtn->setMinimumHeight(38);
+    raceBtn->setStyleSheet(
+        "QPushButton {"
+        "  background-color: #009688;"
+        "  color: white;"
+        "  font-weight: bold;"
+        "  border: none;"
+        "  border-radius: 4px;"
+        "  padding: 8px;"
+        "  font-size: 11px;"
+        "}"
+        "QPushButton:hover { background-color: #00897B; }"
+        "QPushButton:pressed { background-color: #00796B; }"
+    );
+    solveLayout->addWidget(raceBtn);
+    
     // Clear buttons
     QHBoxLayout* clearLayout = new QHBoxLayout();
     
@@ -192,6 +225,76 @@ void MainWindow::setupUI() {
     solveGroup->setLayout(solveLayout);
     controlLayout->addWidget(solveGroup);
     
+    // Animation speed controls
+    QGroupBox* animationGroup = new QGroupBox("Animation");
+    animationGroup->setStyleSheet(
+        "QGroupBox { background-color: #ffffff; color: #000000; border: 1px solid #ddd; border-radius: 4px; padding: 10px; }"
+        "QGroupBox::title { subcontrol-origin: margin; left: 10px; padding: 0 5px; }"
+    );
+    QVBoxLayout* animationLayout = new QVBoxLayout();
+    
+    QHBoxLayout* speedLayout = new QHBoxLayout();
+    QLabel* speedLabel = new QLabel("Speed:");
+    speedLabel->setStyleSheet("color: #000000;");
+    speedLayout->addWidget(speedLabel);
+    speedComboBox = new QComboBox();
+    speedComboBox->addItem("1x", 1);
+    speedComboBox->addItem("10x", 10);
+    speedComboBox->addItem("100x", 100);
+    speedComboBox->addItem("1000x", 1000);
+    speedComboBox->addItem("Max", 0);
+    speedComboBox->setStyleSheet("color: #000000; background-color: white; padding: 5px;");
+    speedLayout->addWidget(speedComboBox);
+    animationLayout->addLayout(speedLayout);
+    
+    skipBtn = new QPushButton("Skip to End");
+    skipBtn->setMinimumHeight(38);
+    skipBtn->setStyleSheet(
+        "QPushButton {"
+        "  background-color: #9C27B0;"
+        "  color: white;"
+        "  font-weight: bold;"
+        "  border: none;"
+        "  border-radius: 4px;"
+        "  padding: 8px;"
+        "  font-size: 11px;"
+        "}"
+        "QPushButton:hover { background-color: #8E24AA; }"
+        "QPushButton:pressed { background-color: #7B1FA2; }"
+    );
+    animationLayout->addWidget(skipBtn);
+    
+    // Replays: record what was shown, or play a recording back with seek
+    QHBoxLayout* replayLayout = new QHBoxLayout();
+    saveReplayBtn = new QPushButton("Save Replay");
+    loadReplayBtn = new QPushButton("Load Replay");
+    for (QPushButton* button : {saveReplayBtn, loadReplayBtn}) {
+        button->setMinimumHeight(32);
+        button->setStyleSheet(
+            "QPushButton {"
+            "  background-color: #5C6BC0;"
+            "  color: white;"
+            "  font-weight: bold;"
+            "  border: none;"
+            "  border-radius: 4px;"
+            "  padding: 6px;"
+            "  font-size: 11px;"
+            "}"
+            "QPushButton:hover { background-color: #5361B5; }"
+            "QPushButton:pressed { background-color: #3F51B5; }"
+        );
+        replayLayout->addWidget(button);
+    }
+    animationLayout->addLayout(replayLayout);
+    
+    replaySlider = new QSlider(Qt::Horizontal);
+    replaySlider->setRange(0, 0);
+    replaySlider->setEnabled(false);
+    animationLayout->addWidget(replaySlider);
+    
+    animationGroup->setLayout(animationLayout);
+    controlLayout->addWidget(animationGroup);
+    
     // Color Legend
     QGroupBox* legendGroup = new QGroupBox("Color Legend");
     legendGroup->setStyleSheet(
@@ -221,6 +324,9 @@ void MainWindow::setupUI() {
     // CENTER - Maze visualization
     graphicsView = new QGraphicsView();
     graphicsView->setStyleSheet("background-color: white; border: 1px solid #ddd; border-radius: 4px;");
+    // Animation frames recolor many cells at once; repaint their bounding
+    // rect in one pass instead of tracking each small region
+    graphicsView->setViewportUpdateMode(QGraphicsView::BoundingRectViewportUpdate);
     mazeScene = new MazeScene(mazeWidth, mazeHeight);
     graphicsView->setScene(mazeScene);
     
@@ -246,26 +352,61 @@ void MainWindow::setupUI() {
     );
     QVBoxLayout* metricsGroupLayout = new QVBoxLayout();
     
-    performanceLabel = new QLabel(
-        "BFS Algorithm:\n"
-        "  Steps Taken: --\n"
-        "  Solve Time: -- ms\n"
-        "  Time Complexity: O(V + E)\n"
-        "  Space Complexity: O(V)\n"
-        "\n"
-        "DFS Algorithm:\n"
-        "  Steps Taken: --\n"
-        "  Solve Time: -- ms\n"
-        "  Time Complexity: O(V + E)\n"
-        "  Space Complexity: O(V)"
-    );
+    performanceLabel = new QLabel();
     performanceLabel->setFont(QFont("Courier", 8));
     performanceLabel->setStyleSheet("color: #000000;");
     performanceLabel->setWordWrap(true);
     metricsGroupLayout->addWidget(performanceLabel);
+    // Result of the last wall edit, kept apart so the stats above survive clicks
+    editStatusLabel = new QLabel();
+    editStatusLabel->setFont(QFont("Courier", 8));
+    editStatusLabel->setStyleSheet("color: #000000;");
+    metricsGroupLayout->addWidget(editStatusLabel);
+    updateStats();
     metricsGroup->setLayout(metricsGroupLayout);
     metricsLayout->addWidget(metricsGroup);
     
+    // Side-by-side race results, one row per registered algorithm
+    QGroupBox* raceGroup = new QGroupBox("Race Results");
+    raceGroup->setStyleSheet(
+        "QGroupBox { background-color: #ffffff; color: #000000; border: 1px solid #ddd; border-radius: 4px; padding: 10px; }"
+        "QGroupBox::title { subcontrol-origin: margin; left: 10px; padding: 0 5px; }"
+    );
+    QVBoxLayout* raceLayout = new QVBoxLayout();
+    raceTable = new QTableWidget(static_cast<int>(PathFinder::algorithms().size()), 4);
+    raceTable->setHorizontalHeaderLabels({"Algorithm", "Expanded", "Wall Time", "Path"});
+    raceTable->verticalHeader()->setVisible(false);
+    raceTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    raceTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    raceTable->setFont(QFont("Courier", 8));
+    raceTable->setStyleSheet("color: #000000; background-color: white;");
+    for (int row = 0; row < raceTable->rowCount(); row++) {
+        QTableWidgetItem* name = new QTableWidgetItem(PathFinder::algorithms()[row].name);
+        name->setForeground(MazeScene::raceColor(row).darker(130));
+        raceTable->setItem(row, 0, name);
+        for (int column = 1; column < 4; column++) {
+            raceTable->setItem(row, column, new QTableWidgetItem("--"));
+        }
+    }
+    raceLayout->addWidget(raceTable);
+    raceGroup->setLayout(raceLayout);
+    metricsLayout->addWidget(raceGroup);
+    
+    // Tracked allocations per engine subsystem plus process peak RSS
+    QGroupBox* memoryGroup = new QGroupBox("Memory");
+    memoryGroup->setStyleSheet(
+        "QGroupBox { background-color: #ffffff; color: #000000; border: 1px solid #ddd; border-radius: 4px; padding: 10px; }"
+        "QGroupBox::title { subcontrol-origin: margin; left: 10px; padding: 0 5px; }"
+    );
+    QVBoxLayout* memoryLayout = new QVBoxLayout();
+    memoryLabel = new QLabel();
+    memoryLabel->setFont(QFont("Courier", 8));
+    memoryLabel->setStyleSheet("color: #000000;");
+    memoryLayout->addWidget(memoryLabel);
+    memoryGroup->setLayout(memoryLayout);
+    metricsLayout->addWidget(memoryGroup);
+    updateMemoryStats();
+    
     metricsLayout->addStretch();
     metricsPanel->setMaximumWidth(280);
     metricsPanel->setMinimumWidth(250);
@@ -277,8 +418,71 @@ void MainWindow::connectSignals() {
     connect(generateBtn, &QPushButton::clicked, this, &MainWindow::onGenerateClicked);
     connect(bfsBtn, &QPushButton::clicked, this, &MainWindow::onBFSClicked);
     connect(dfsBtn, &QPushButton::clicked, this, &MainWindow::onDFSClicked);
+    connect(raceBtn, &QPushButton::clicked, this, &MainWindow::onRaceClicked);
     connect(clearBtn, &QPushButton::clicked, this, &MainWindow::onClearClicked);
     connect(deleteBtn, &QPushButton::clicked, this, &MainWindow::onDeleteClicked);
+    connect(skipBtn, &QPushButton::clicked, this, &MainWindow::onSkipClicked);
+    connect(speedComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onSpeedChanged);
+    connect(saveReplayBtn, &QPushButton::clicked, this, &MainWindow::onSaveReplayClicked);
+    connect(loadReplayBtn, &QPushButton::clicked, this, &MainWindow::onLoadReplayClicked);
+    connect(replaySlider, &QSlider::sliderMoved, this, &MainWindow::onReplaySliderMoved);
+    // Let go of the handle to carry on playing from there
+    connect(replaySlider, &QSlider::sliderReleased, this, [this]() { mazeScene->resumeReplay(); });
+    connectSceneSignals();
+}
+
+void MainWindow::connectSceneSignals() {
+    mazeScene->setSolutionCache(&solutionCache);
+    connect(mazeScene, &MazeScene::raceProgress, this, &MainWindow::updateRaceTable);
+    connect(mazeScene, &MazeScene::replayProgress, this, &MainWindow::updateReplaySlider);
+    editStatusLabel->clear();
+    connect(mazeScene, &MazeScene::wallToggled, this, [this](bool goalReachable) {
+        editStatusLabel->setText(goalReachable ? "Wall toggled: goal reachable"
+                                               : "Wall toggled: goal unreachable");
+        updateReplaySlider();
+    });
+    // Render time keeps accumulating while the solve animates, so refresh
+    // the panel once the scene is done drawing
+    connect(mazeScene, &MazeScene::animationFinished, this, [this]() {
+        captureStats();
+        updateStats();
+    });
+}
+
+void MainWindow::onRaceClicked() {
+    if (!mazeScene->getMaze()) {
+        performanceLabel->setText("Generate a maze first!");
+        return;
+    }
+    
+    mazeScene->startRace();
+    updateRaceTable();
+}
+
+void MainWindow::updateRaceTable() {
+    const SolverRace* race = mazeScene->getRace();
+    if (!race) return;
+    
+    for (int row = 0; row < race->laneCount() && row < raceTable->rowCount(); row++) {
+        const RaceLane& lane = race->lane(row);
+        bool finished = lane.finished.load(std::memory_order_acquire);
+        
+        raceTable->item(row, 1)->setText(QString::number(lane.progress.nodesExpanded.load(std::memory_order_relaxed)));
+        raceTable->item(row, 2)->setText(finished ? formatNs(lane.wallNs) : QString("running"));
+        raceTable->item(row, 3)->setText(finished ? QString::number(lane.result.path.size()) : QString("--"));
+    }
+}
+
+void MainWindow::captureStats() {
+    const PathResult& result = mazeScene->getCurrentPath();
+    if (mazeScene->getSolvingAlgorithm() == "BFS") {
+        bfsSteps = result.stepsCount;
+        bfsStats = mazeScene->getCurrentStats();
+    } else if (mazeScene->getSolvingAlgorithm() == "DFS") {
+        dfsSteps = result.stepsCount;
+        dfsStats = mazeScene->getCurrentStats();
+    }
 }
 
 void MainWindow::onGenerateClicked() {
@@ -287,15 +491,18 @@ void MainWindow::onGenerateClicked() {
     
     delete mazeScene;
     mazeScene = new MazeScene(mazeWidth, mazeHeight);
+    mazeScene->setAnimationSpeed(speedComboBox->currentData().toInt());
     graphicsView->setScene(mazeScene);
+    connectSceneSignals();
     
     bfsSteps = 0;
     dfsSteps = 0;
-    bfsTime = 0;
-    dfsTime = 0;
+    bfsStats = SearchStats();
+    dfsStats = SearchStats();
     
     mazeScene->generateNewMaze();
     updateStats();
+    updateReplaySlider();
 }
 
 void MainWindow::onBFSClicked() {
@@ -304,14 +511,8 @@ void MainWindow::onBFSClicked() {
         return;
     }
     
-    QElapsedTimer timer;
-    timer.start();
-    
     mazeScene->solveMazeWithBFS();
-    
-    bfsTime = timer.elapsed();
-    bfsSteps = mazeScene->getCurrentPath().stepsCount;
-    
+    captureStats();
     updateStats();
 }
 
@@ -321,14 +522,8 @@ void MainWindow::onDFSClicked() {
         return;
     }
     
-    QElapsedTimer timer;
-    timer.start();
-    
     mazeScene->solveMazeWithDFS();
-    
-    dfsTime = timer.elapsed();
-    dfsSteps = mazeScene->getCurrentPath().stepsCount;
-    
+    captureStats();
     updateStats();
 }
 
@@ -338,42 +533,138 @@ void MainWindow::onClearClicked() {
     mazeScene->clearSolution();
     bfsSteps = 0;
     dfsSteps = 0;
-    bfsTime = 0;
-    dfsTime = 0;
+    bfsStats = SearchStats();
+    dfsStats = SearchStats();
     updateStats();
+    updateReplaySlider();
 }
 
 void MainWindow::onDeleteClicked() {
     if (!mazeScene->getMaze()) return;
     
     mazeScene->resetMaze();
+    editStatusLabel->clear();
+    bfsSteps = 0;
+    dfsSteps = 0;
+    bfsStats = SearchStats();
+    dfsStats = SearchStats();
+    updateStats();
+    updateReplaySlider();
+}
+
+void MainWindow::onSkipClicked() {
+    mazeScene->skipAnimation();
+}
+
+void MainWindow::onSpeedChanged(int index) {
+    mazeScene->setAnimationSpeed(speedComboBox->itemData(index).toInt());
+}
+
+void MainWindow::onSaveReplayClicked() {
+    QString filename = QFileDialog::getSaveFileName(this, "Save Replay", QString(), "Maze replays (*.mzrp)");
+    if (filename.isEmpty()) return;
+    
+    QString error;
+    if (!mazeScene->saveReplay(filename, &error)) {
+        QMessageBox::warning(this, "Save Replay", error);
+    }
+}
+
+void MainWindow::onLoadReplayClicked() {
+    QString filename = QFileDialog::getOpenFileName(this, "Load Replay", QString(), "Maze replays (*.mzrp)");
+    if (filename.isEmpty()) return;
+    
+    std::string error;
+    std::shared_ptr<const MazeReplay> replay = loadReplay(filename.toStdString(), &error);
+    if (!replay) {
+        QMessageBox::warning(this, "Load Replay", QString::fromStdString(error));
+        return;
+    }
+    
+    // A fresh scene sized to the recording, as Generate does
+    mazeWidth = replay->width;
+    mazeHeight = replay->height;
+    delete mazeScene;
+    mazeScene = new MazeScene(mazeWidth, mazeHeight);
+    mazeScene->setAnimationSpeed(speedComboBox->currentData().toInt());
+    graphicsView->setScene(mazeScene);
+    connectSceneSignals();
+    
     bfsSteps = 0;
     dfsSteps = 0;
-    bfsTime = 0;
-    dfsTime = 0;
+    bfsStats = SearchStats();
+    dfsStats = SearchStats();
+    
+    mazeScene->playReplay(replay);
     updateStats();
 }
 
+void MainWindow::onReplaySliderMoved(int step) {
+    mazeScene->seekReplay(step);
+}
+
+void MainWindow::updateReplaySlider() {
+    // Programmatic moves must not feed back into seekReplay
+    QSignalBlocker blocker(replaySlider);
+    replaySlider->setEnabled(mazeScene->hasReplay());
+    replaySlider->setRange(0, static_cast<int>(mazeScene->getReplayLength()));
+    replaySlider->setValue(static_cast<int>(mazeScene->getReplayPosition()));
+}
+
 void MainWindow::updateStats() {
-    PathResult path = mazeScene->getCurrentPath();
-    
-    QString stats = QString(
-        "BFS Algorithm:\n"
-        "  Steps Taken: %1\n"
-        "  Solve Time: %2 ms\n"
-        "  Time Complexity: O(V + E)\n"
-        "  Space Complexity: O(V)\n"
-        "\n"
-        "DFS Algorithm:\n"
-        "  Steps Taken: %3\n"
-        "  Solve Time: %4 ms\n"
-        "  Time Complexity: O(V + E)\n"
-        "  Space Complexity: O(V)"
-    ).arg(bfsSteps)
-     .arg(bfsTime)
-     .arg(dfsSteps)
-     .arg(dfsTime);
+    auto describe = [](const QString& name, int steps, const SearchStats& stats) {
+        return QString(
+            "%1 Algorithm:\n"
+            "  Steps Taken: %2\n"
+            "  Setup Time: %3\n"
+            "  Search Time: %4\n"
+            "  Path Rebuild: %5\n"
+            "  Render Time: %6\n"
+            "  Nodes Expanded: %7\n"
+            "  Peak Frontier: %8\n"
+            "  Neighbor Checks: %9\n"
+            "  Memory: %10\n"
+            "  Time Complexity: O(V + E)\n"
+            "  Space Complexity: O(V)"
+        ).arg(name)
+         .arg(steps)
+         .arg(formatNs(stats.setupNs))
+         .arg(formatNs(stats.searchNs))
+         .arg(formatNs(stats.reconstructNs))
+         .arg(formatNs(stats.renderNs))
+         .arg(stats.nodesExpanded)
+         .arg(stats.peakFrontier)
+         .arg(stats.neighborChecks)
+         .arg(formatBytes(stats.bytesAllocated));
+    };
+    
+    QString stats = describe("BFS", bfsSteps, bfsStats) + "\n\n" + describe("DFS", dfsSteps, dfsStats);
+    
+    CacheStats cache = solutionCache.stats();
+    stats += QString("\n\nSolution Cache: %1 hits, %2 misses\n  Entries: %3 / %4")
+        .arg(cache.hits)
+        .arg(cache.misses)
+        .arg(cache.entries)
+        .arg(cache.capacity);
     
     performanceLabel->setText(stats);
     performanceLabel->setStyleSheet("color: #000000;");
-}
\ No newline at end of file
+    
+    if (memoryLabel) {
+        updateMemoryStats();
+    }
+}
+
+void MainWindow::updateMemoryStats() {
+    QString text = "Subsystem: current / peak\n";
+    for (const SubsystemMemory& m : MemoryTracker::snapshot()) {
+        text += QString("  %1: %2 / %3\n")
+            .arg(m.name)
+            .arg(formatBytes(m.currentBytes))
+            .arg(formatBytes(m.peakBytes));
+    }
+    text += QString("\nProcess RSS: %1\nPeak RSS: %2")
+        .arg(formatBytes(MemoryTracker::currentRssBytes()))
+        .arg(formatBytes(MemoryTracker::peakRssBytes()));
+    memoryLabel->setText(text);
+}
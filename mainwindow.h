@@ -6,6 +6,9 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QSpinBox>
+#include <QComboBox>
+#include <QSlider>
+#include <QTableWidget>
 #include "mazescene.h"
 
 class MainWindow : public QMainWindow {
@@ -21,14 +24,25 @@ private:
     QPushButton* generateBtn;
     QPushButton* bfsBtn;
     QPushButton* dfsBtn;
+    QPushButton* raceBtn;
     QPushButton* clearBtn;
     QPushButton* deleteBtn;
+    QPushButton* skipBtn;
+    QPushButton* saveReplayBtn;
+    QPushButton* loadReplayBtn;
+    QSlider* replaySlider;
+    QComboBox* speedComboBox;
     QLabel* performanceLabel;
+    QLabel* editStatusLabel;
+    QTableWidget* raceTable;
+    QLabel* memoryLabel;
     QLabel* titleLabel;
     
     int mazeWidth, mazeHeight;
     int bfsSteps, dfsSteps;
-    int bfsTime, dfsTime;
+    SearchStats bfsStats, dfsStats;
+    // Outlives each scene; results are keyed by maze fingerprint
+    SolutionCache solutionCache;
 
 public:
     MainWindow(QWidget* parent = nullptr);
@@ -38,13 +52,24 @@ private slots:
     void onGenerateClicked();
     void onBFSClicked();
     void onDFSClicked();
+    void onRaceClicked();
+    void updateRaceTable();
     void onClearClicked();
     void onDeleteClicked();
+    void onSkipClicked();
+    void onSpeedChanged(int index);
+    void onSaveReplayClicked();
+    void onLoadReplayClicked();
+    void onReplaySliderMoved(int step);
+    void updateReplaySlider();
     void updateStats();
+    void updateMemoryStats();
     
 private:
     void setupUI();
     void connectSignals();
+    void connectSceneSignals();
+    void captureStats();
 };
 
 #endif // MAINWINDOW_H
\ No newline at end of file
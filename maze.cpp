@@ -1,144 +1,390 @@
 #include "maze.h"
+#include "mazerng.h"
+#include "mazeutil.h"
+#include "tracer.h"
 #include <algorithm>
 #include <random>
 
-Maze::Maze(int w, int h) : width(w), height(h) {
-    grid.resize(h, std::vector<Cell>(w));
+namespace {
+
+uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Zobrist keys are hashed from the slot number instead of stored, so the
+// fingerprint needs no per-cell table
+uint64_t wallKey(size_t cell, int bit) {
+    return mix64((static_cast<uint64_t>(cell) * 4 + bit) * 0x9e3779b97f4a7c15ULL + 0x5851f42d4c957f2dULL);
+}
+
+uint64_t weightKey(size_t cell, int weight) {
+    if (weight == 1) return 0;   // default weight contributes nothing
+    return mix64((static_cast<uint64_t>(cell) << 16 | static_cast<uint64_t>(weight)) * 0x9e3779b97f4a7c15ULL
+                 + 0x14057b7ef767814fULL);
+}
+
+} // namespace
+
+Maze::Maze(int w, int h)
+    : width(w), height(h),
+      grid(static_cast<size_t>(w) * h, AllWalls, MemoryTracker::resource(MemorySubsystem::MazeGrid)),
+      layout(CellLayoutKind::RowMajor, w, h),
+      layoutGrid(MemoryTracker::resource(MemorySubsystem::MazeGrid)),
+      wallRemovalOrder(MemoryTracker::resource(MemorySubsystem::WallRemovalOrder)),
+      seed(0), stream(0), weightFormat(WeightFormat::None),
+      weights8(MemoryTracker::resource(MemorySubsystem::MazeWeights)),
+      weights16(MemoryTracker::resource(MemorySubsystem::MazeWeights)),
+      wallHash(0), weightHash(0) {}
+
+Maze::Maze(const Maze& other)
+    : width(other.width), height(other.height),
+      grid(other.grid, MemoryTracker::resource(MemorySubsystem::MazeGrid)),
+      layout(other.layout),
+      layoutGrid(other.layoutGrid, MemoryTracker::resource(MemorySubsystem::MazeGrid)),
+      wallRemovalOrder(other.wallRemovalOrder, MemoryTracker::resource(MemorySubsystem::WallRemovalOrder)),
+      seed(other.seed), stream(other.stream), weightFormat(other.weightFormat),
+      weights8(other.weights8, MemoryTracker::resource(MemorySubsystem::MazeWeights)),
+      weights16(other.weights16, MemoryTracker::resource(MemorySubsystem::MazeWeights)),
+      wallHash(other.wallHash), weightHash(other.weightHash) {}
+
+Maze& Maze::operator=(const Maze& other) {
+    if (this == &other) return *this;
+    // pmr containers keep their own resource on assignment, so only the
+    // contents are copied and the accounting stays with each subsystem
+    width = other.width;
+    height = other.height;
+    grid = other.grid;
+    layout = other.layout;
+    layoutGrid = other.layoutGrid;
+    wallRemovalOrder = other.wallRemovalOrder;
+    seed = other.seed;
+    stream = other.stream;
+    weightFormat = other.weightFormat;
+    weights8 = other.weights8;
+    weights16 = other.weights16;
+    wallHash = other.wallHash;
+    weightHash = other.weightHash;
+    return *this;
 }
 
 void Maze::reset() {
     wallRemovalOrder.clear();
     
     // Initialize all cells with all walls
+    std::fill(grid.begin(), grid.end(), AllWalls);
+    std::fill(layoutGrid.begin(), layoutGrid.end(), AllWalls);
+    wallHash = 0;
+}
+
+void Maze::setCellLayout(CellLayoutKind kind) {
+    layout = CellLayout(kind, width, height);
+    if (layout.isRowMajor()) {
+        layoutGrid.clear();
+        layoutGrid.shrink_to_fit();
+        return;
+    }
+    layoutGrid.assign(layout.size(), AllWalls);
+    syncLayoutGrid();
+}
+
+void Maze::syncLayoutGrid() {
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
-            grid[y][x] = Cell();
+            layoutGrid[layout.index(x, y)] = at(x, y);
         }
     }
 }
 
+void Maze::setMask(int x, int y, uint8_t mask) {
+    size_t cell = static_cast<size_t>(y) * width + x;
+    uint8_t changed = grid[cell] ^ mask;
+    for (int bit = 0; changed != 0; bit++, changed >>= 1) {
+        if (changed & 1) wallHash ^= wallKey(cell, bit);
+    }
+    grid[cell] = mask;
+    if (!layoutGrid.empty()) {
+        layoutGrid[layout.index(x, y)] = mask;
+    }
+}
+
+void Maze::removeWall(const Wall& wall) {
+    if (wall.x1 == wall.x2) {
+        // Vertical neighbors: wall between (x1,y1) and (x1,y2)
+        setWall(wall.x1, std::min(wall.y1, wall.y2), 2, false);
+    } else {
+        // Horizontal neighbors: wall between (x1,y1) and (x2,y1)
+        setWall(std::min(wall.x1, wall.x2), wall.y1, 1, false);
+    }
+}
+
+void Maze::setWall(int x, int y, int direction, bool present) {
+    if (x < 0 || x >= width || y < 0 || y >= height || direction < 0 || direction > 3) return;
+
+    static const int dx[4] = {0, 1, 0, -1};
+    static const int dy[4] = {-1, 0, 1, 0};
+    auto apply = [&](int cx, int cy, int d) {
+        size_t cell = static_cast<size_t>(cy) * width + cx;
+        uint8_t bit = static_cast<uint8_t>(1 << d);
+        setMask(cx, cy, present ? (grid[cell] | bit) : (grid[cell] & ~bit));
+    };
+
+    apply(x, y, direction);
+    int nx = x + dx[direction], ny = y + dy[direction];
+    if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
+        apply(nx, ny, (direction + 2) % 4);
+    }
+}
+
+bool Maze::toggleWall(int x, int y, int direction) {
+    if (x < 0 || x >= width || y < 0 || y >= height || direction < 0 || direction > 3) return true;
+    static const int dx[4] = {0, 1, 0, -1};
+    static const int dy[4] = {-1, 0, 1, 0};
+    int nx = x + dx[direction], ny = y + dy[direction];
+    if (nx < 0 || nx >= width || ny < 0 || ny >= height) return true;
+
+    bool present = !hasWall(x, y, direction);
+    setWall(x, y, direction, present);
+    return present;
+}
+
+uint64_t Maze::fingerprint() const {
+    uint64_t size = static_cast<uint64_t>(static_cast<uint32_t>(width)) << 32 | static_cast<uint32_t>(height);
+    return mix64(wallHash ^ weightHash ^ mix64(size));
+}
+
 void Maze::generateMaze(int extraCycles) {
+    std::random_device rd;
+    generateMaze(extraCycles, rd());
+}
+
+void Maze::generateMaze(int extraCycles, unsigned int seed, std::pmr::memory_resource* scratch) {
+    generateMaze(extraCycles, seed, 0, scratch);
+}
+
+void Maze::generateMaze(int extraCycles, unsigned int seed, uint64_t stream,
+                        std::pmr::memory_resource* scratch) {
+    TRACE_SCOPE("maze", "generateMaze");
+    this->seed = seed;
+    this->stream = stream;
     wallRemovalOrder.clear();
     
     // Initialize all cells with all walls
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            grid[y][x] = Cell();
-        }
-    }
+    std::fill(grid.begin(), grid.end(), AllWalls);
+    wallHash = 0;
+
+    // Walls come down in random order, so mirroring each one into the
+    // layout copy would double the cache misses; refill it once at the end
+    std::pmr::vector<uint8_t> mirror(layoutGrid.get_allocator().resource());
+    mirror.swap(layoutGrid);
     
-    // Create list of all possible walls
-    std::vector<Wall> walls;
+    std::pmr::memory_resource* wallResource =
+        scratch ? scratch : MemoryTracker::resource(MemorySubsystem::GenerationWalls);
+    std::pmr::memory_resource* unionResource =
+        scratch ? scratch : MemoryTracker::resource(MemorySubsystem::UnionFind);
     
-    // Horizontal walls (between rows)
-    for (int y = 0; y < height - 1; y++) {
-        for (int x = 0; x < width; x++) {
-            walls.push_back(Wall(x, y, x, y + 1));
-        }
-    }
+    // Every list has a known final size, so size them once up front
+    size_t cellCount = static_cast<size_t>(width) * height;
+    size_t wallCount = static_cast<size_t>(height - 1) * width + static_cast<size_t>(height) * (width - 1);
+    size_t treeEdges = cellCount - 1;
     
-    // Vertical walls (between columns)
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width - 1; x++) {
-            walls.push_back(Wall(x, y, x + 1, y));
+    // Create list of all possible walls
+    std::pmr::vector<Wall> walls(wallResource);
+    {
+        TRACE_SCOPE("maze", "build wall list");
+        walls.reserve(wallCount);
+        
+        // Horizontal walls (between rows)
+        for (int y = 0; y < height - 1; y++) {
+            for (int x = 0; x < width; x++) {
+                walls.push_back(Wall(x, y, x, y + 1));
+            }
+        }
+        
+        // Vertical walls (between columns)
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width - 1; x++) {
+                walls.push_back(Wall(x, y, x + 1, y));
+            }
         }
     }
     
-    // Shuffle walls randomly using modern C++ random
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::shuffle(walls.begin(), walls.end(), gen);
+    // Shuffle walls with the counter-based generator for this seed and stream
+    CounterRng rng(seed, stream);
+    {
+        TRACE_SCOPE("maze", "shuffle walls");
+        shuffleRange(walls.begin(), walls.end(), rng);
+    }
     
     // List to keep track of walls we didn't remove
-    std::vector<Wall> skippedWalls;
+    std::pmr::vector<Wall> skippedWalls(wallResource);
+    skippedWalls.reserve(wallCount - treeEdges);
+    wallRemovalOrder.reserve(treeEdges + std::max(extraCycles, 0));
 
-    // Union-Find for Kruskal's algorithm
-    UnionFind uf(width * height);
+    // Union-Find for Kruskal's algorithm, indexed in the cell layout so
+    // neighbouring cells' parents share cache lines
+    UnionFind uf(static_cast<int>(layout.size()), unionResource);
     
     // Process each wall
-    for (const Wall& wall : walls) {
-        int cell1 = wall.y1 * width + wall.x1;
-        int cell2 = wall.y2 * width + wall.x2;
-        
-        // If cells are not connected, remove wall and unite them
-        if (!uf.connected(cell1, cell2)) {
-            uf.unite(cell1, cell2);
-            wallRemovalOrder.push_back(wall);
+    {
+        TRACE_SCOPE("maze", "union-find loop");
+        for (const Wall& wall : walls) {
+            int cell1 = static_cast<int>(layout.index(wall.x1, wall.y1));
+            int cell2 = static_cast<int>(layout.index(wall.x2, wall.y2));
             
-            // Remove wall from grid
-            if (wall.x1 == wall.x2) {
-                // Vertical wall between (x1,y1) and (x1,y2)
-                if (wall.y1 < wall.y2) {
-                    grid[wall.y1][wall.x1].bottom = false;
-                    grid[wall.y2][wall.x2].top = false;
-                } else {
-                    grid[wall.y2][wall.x2].bottom = false;
-                    grid[wall.y1][wall.x1].top = false;
-                }
+            // If cells are not connected, remove wall and unite them
+            if (uf.unite(cell1, cell2)) {
+                wallRemovalOrder.push_back(wall);
+                removeWall(wall);
             } else {
-                // Horizontal wall between (x1,y1) and (x2,y1)
-                if (wall.x1 < wall.x2) {
-                    grid[wall.y1][wall.x1].right = false;
-                    grid[wall.y2][wall.x2].left = false;
-                } else {
-                    grid[wall.y2][wall.x2].right = false;
-                    grid[wall.y1][wall.x1].left = false;
-                }
+                // save(Keep track of skipped) walls for later
+                skippedWalls.push_back(wall);
             }
-            // removeWallFromGrid(wall); // Refactored helper or inline code
-        } else {
-            // save(Keep track of skipped) walls for later
-            skippedWalls.push_back(wall);
         }
     }
 
     // NEW: Add cycles by removing some skipped walls
-    std::shuffle(skippedWalls.begin(), skippedWalls.end(), gen);
+    {
+        TRACE_SCOPE("maze", "cycle injection");
+        shuffleRange(skippedWalls.begin(), skippedWalls.end(), rng);
 
-    for (int i = 0; i < extraCycles && i < skippedWalls.size(); i++) {
-        Wall wall = skippedWalls[i];
-        wallRemovalOrder.push_back(wall); // Add to animation order
-        
-        // Remove wall from grid (copy logic from above)
-        if (wall.x1 == wall.x2) {
-             // Vertical wall logic...
-             if (wall.y1 < wall.y2) {
-                grid[wall.y1][wall.x1].bottom = false;
-                grid[wall.y2][wall.x2].top = false;
-            } else {
-                grid[wall.y2][wall.x2].bottom = false;
-                grid[wall.y1][wall.x1].top = false;
-            }
-        } else {
-            // Horizontal wall logic...
-            if (wall.x1 < wall.x2) {
-                grid[wall.y1][wall.x1].right = false;
-                grid[wall.y2][wall.x2].left = false;
-            } else {
-                grid[wall.y2][wall.x2].right = false;
-                grid[wall.y1][wall.x1].left = false;
-            }
+        for (int i = 0; i < extraCycles && i < static_cast<int>(skippedWalls.size()); i++) {
+            const Wall& wall = skippedWalls[i];
+            wallRemovalOrder.push_back(wall); // Add to animation order
+            removeWall(wall);
         }
     }
+
+    mirror.swap(layoutGrid);
+    if (!layoutGrid.empty()) syncLayoutGrid();
 }
 
 Cell Maze::getCell(int x, int y) const {
+    Cell cell;
+    if (x >= 0 && x < width && y >= 0 && y < height) {
+        uint8_t mask = at(x, y);
+        cell.top = mask & WallTop;
+        cell.right = mask & WallRight;
+        cell.bottom = mask & WallBottom;
+        cell.left = mask & WallLeft;
+    }
+    return cell;
+}
+
+void Maze::setCell(int x, int y, const Cell& cell) {
     if (x >= 0 && x < width && y >= 0 && y < height) {
-        return grid[y][x];
+        setMask(x, y,
+                (cell.top ? WallTop : 0) | (cell.right ? WallRight : 0)
+                | (cell.bottom ? WallBottom : 0) | (cell.left ? WallLeft : 0));
     }
-    return Cell();
+}
+
+void Maze::rewriteWallMasks(const std::function<void(uint8_t* masks)>& fill, int threads) {
+    TRACE_SCOPE("maze", "rewriteWallMasks");
+    wallRemovalOrder.clear();
+    fill(grid.data());
+
+    // Same hash as setMask builds up one change at a time: a key per open bit
+    size_t cells = grid.size();
+    int stripeCount = static_cast<int>(std::clamp<size_t>(static_cast<size_t>(resolveThreads(threads)), 1,
+                                                          std::max<size_t>(cells / 65536, 1)));
+    std::vector<uint64_t> partial(stripeCount, 0);
+    forEachStripe(stripeCount, cells, [&](int s, size_t first, size_t last) {
+        uint64_t hash = 0;
+        for (size_t cell = first; cell < last; cell++) {
+            // Branch-free: all four keys, masked by whether the bit is open
+            uint64_t open = ~grid[cell] & AllWalls;
+            for (int bit = 0; bit < 4; bit++) {
+                hash ^= wallKey(cell, bit) & (0 - ((open >> bit) & 1));
+            }
+        }
+        partial[s] = hash;
+    });
+    wallHash = 0;
+    for (uint64_t hash : partial) wallHash ^= hash;
+
+    if (!layoutGrid.empty()) syncLayoutGrid();
 }
 
 bool Maze::hasWall(int x, int y, int direction) const {
-    if (x < 0 || x >= width || y < 0 || y >= height) {
+    if (x < 0 || x >= width || y < 0 || y >= height || direction < 0 || direction > 3) {
         return true;
     }
     
-    switch (direction) {
-        case 0: return grid[y][x].top;      // top
-        case 1: return grid[y][x].right;    // right
-        case 2: return grid[y][x].bottom;   // bottom
-        case 3: return grid[y][x].left;     // left
-    }
-    return true;
-}
\ No newline at end of file
+    // 0 top, 1 right, 2 bottom, 3 left map straight onto WallBits
+    return (at(x, y) >> direction) & 1;
+}
+
+void Maze::enableWeights(WeightFormat format) {
+    if (format == weightFormat) return;
+    size_t cells = static_cast<size_t>(width) * height;
+
+    if (format == WeightFormat::UInt16) {
+        // Widen, keeping any 8-bit weights already set
+        weights16.assign(cells, 1);
+        if (weightFormat == WeightFormat::UInt8) {
+            std::copy(weights8.begin(), weights8.end(), weights16.begin());
+        }
+        weights8 = std::pmr::vector<uint8_t>(weights8.get_allocator());
+    } else if (format == WeightFormat::UInt8) {
+        weights8.assign(cells, 1);
+        if (weightFormat == WeightFormat::UInt16) {
+            for (size_t i = 0; i < cells; i++) {
+                weights8[i] = static_cast<uint8_t>(std::min<int>(weights16[i], 255));
+            }
+        }
+        weights16 = std::pmr::vector<uint16_t>(weights16.get_allocator());
+    } else {
+        clearWeights();
+        return;
+    }
+    weightFormat = format;
+    rehashWeights();   // narrowing may have clamped
+}
+
+void Maze::clearWeights() {
+    // Give the memory back, not just the size
+    weights8 = std::pmr::vector<uint8_t>(weights8.get_allocator());
+    weights16 = std::pmr::vector<uint16_t>(weights16.get_allocator());
+    weightFormat = WeightFormat::None;
+    weightHash = 0;
+}
+
+void Maze::storeWeight(size_t cell, int weight) {
+    int old = weightFormat == WeightFormat::UInt8 ? weights8[cell] : weights16[cell];
+    weightHash ^= weightKey(cell, old) ^ weightKey(cell, weight);
+    if (weightFormat == WeightFormat::UInt8) weights8[cell] = static_cast<uint8_t>(weight);
+    else weights16[cell] = static_cast<uint16_t>(weight);
+}
+
+void Maze::rehashWeights() {
+    weightHash = 0;
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+        weightHash ^= weightKey(i, getWeight(static_cast<int>(i % width), static_cast<int>(i / width)));
+    }
+}
+
+void Maze::setWeight(int x, int y, int weight) {
+    if (x < 0 || x >= width || y < 0 || y >= height) return;
+    weight = std::clamp(weight, 1, 65535);
+
+    if (weight > 255 && weightFormat != WeightFormat::UInt16) {
+        enableWeights(WeightFormat::UInt16);
+    } else if (weightFormat == WeightFormat::None) {
+        enableWeights(WeightFormat::UInt8);
+    }
+
+    storeWeight(static_cast<size_t>(y) * width + x, weight);
+}
+
+void Maze::fillRandomWeights(int maxWeight, unsigned int seed) {
+    maxWeight = std::clamp(maxWeight, 1, 65535);
+    enableWeights(maxWeight > 255 ? WeightFormat::UInt16 : WeightFormat::UInt8);
+
+    // Complemented 64-bit key: no 32-bit maze seed maps to these streams
+    CounterRng rng(~static_cast<uint64_t>(seed));
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+        storeWeight(i, 1 + static_cast<int>(rng.below(static_cast<uint64_t>(maxWeight))));
+    }
+}
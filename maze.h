@@ -1,8 +1,13 @@
 #ifndef MAZE_H
 #define MAZE_H
 
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
 #include <vector>
 #include <queue>
+#include "celllayout.h"
+#include "memorytracker.h"
 #include "unionfind.h"
 
 struct Cell {
@@ -12,6 +17,22 @@ struct Cell {
     bool right = true;
 };
 
+// Wall bits of one cell, indexed by direction (0=top, 1=right, 2=bottom, 3=left)
+enum WallBits : uint8_t {
+    WallTop = 1,
+    WallRight = 2,
+    WallBottom = 4,
+    WallLeft = 8,
+    AllWalls = 15
+};
+
+// Storage for the optional per-cell weight layer
+enum class WeightFormat {
+    None,       // unweighted: every cell costs 1, no memory used
+    UInt8,      // weights 1..255
+    UInt16      // weights 1..65535
+};
+
 struct Wall {
     int x1, y1, x2, y2;
     Wall(int a, int b, int c, int d) : x1(a), y1(b), x2(c), y2(d) {}
@@ -20,21 +41,110 @@ struct Wall {
 class Maze {
 private:
     int width, height;
-    std::vector<std::vector<Cell>> grid;
-    std::vector<Wall> wallRemovalOrder;
+    // Allocations are accounted per subsystem through MemoryTracker.
+    // One WallBits mask per cell in a row-major block, indexed y * width + x.
+    std::pmr::vector<uint8_t> grid;
+    // Traversal layout, and for the tiled ones a copy of grid in that order
+    // that setMask keeps in step (empty for RowMajor)
+    CellLayout layout;
+    std::pmr::vector<uint8_t> layoutGrid;
+    std::pmr::vector<Wall> wallRemovalOrder;
+    unsigned int seed;
+    uint64_t stream;
+    // Terrain cost of entering each cell; at most one of these is in use
+    WeightFormat weightFormat;
+    std::pmr::vector<uint8_t> weights8;
+    std::pmr::vector<uint16_t> weights16;
+    // Zobrist-style fingerprint parts: XOR of a hashed key per open wall bit
+    // and per cell whose weight is not 1; updated on every change
+    uint64_t wallHash;
+    uint64_t weightHash;
+    
+    uint8_t& at(int x, int y) { return grid[static_cast<size_t>(y) * width + x]; }
+    uint8_t at(int x, int y) const { return grid[static_cast<size_t>(y) * width + x]; }
+    void removeWall(const Wall& wall);
+    void setMask(int x, int y, uint8_t mask);
+    void syncLayoutGrid();
+    void storeWeight(size_t cell, int weight);
+    void rehashWeights();
     
 public:
     Maze(int w, int h);
+    // Copies allocate from the same tracked resources as the original; a
+    // defaulted copy would fall back to the default pmr resource
+    Maze(const Maze& other);
+    Maze& operator=(const Maze& other);
+    Maze(Maze&&) = default;
+    Maze& operator=(Maze&&) = default;
     
     // Generate maze using Randomized Kruskal's algorithm
     void generateMaze(int extraCycles = 0);
+    // Same, but reproducible: equal seeds give identical mazes. Temporaries
+    // (wall lists, Union-Find) come from scratch when given, e.g. a MazeArena
+    // that the caller resets between runs.
+    void generateMaze(int extraCycles, unsigned int seed,
+                      std::pmr::memory_resource* scratch = nullptr);
+    // Maze number stream of the batch seeded with seed; each stream is an
+    // independent random sequence (the overload above is stream 0)
+    void generateMaze(int extraCycles, unsigned int seed, uint64_t stream,
+                      std::pmr::memory_resource* scratch = nullptr);
     void reset();
     
     // Getters
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     Cell getCell(int x, int y) const;
-    const std::vector<Wall>& getWallRemovalOrder() const { return wallRemovalOrder; }
+    void setCell(int x, int y, const Cell& cell);
+    // Bulk writer for importers: fill receives the row-major masks to
+    // overwrite in place (from as many threads as it likes), then the
+    // fingerprint is rebuilt over up to threads threads (0 = all cores) and
+    // the layout copy refreshed. Clears the wall removal order.
+    void rewriteWallMasks(const std::function<void(uint8_t* masks)>& fill, int threads = 1);
+    const std::pmr::vector<Wall>& getWallRemovalOrder() const { return wallRemovalOrder; }
+    // Raw wall masks, width * height bytes in row-major order
+    const uint8_t* wallMasks() const { return grid.data(); }
+
+    // Cell layout used by generateMaze's union-find and by PathFinder. Wall
+    // masks stay row-major for I/O and the scanning passes; a tiled layout
+    // adds a mirrored copy (one more byte per cell) for the solvers to read.
+    void setCellLayout(CellLayoutKind kind);
+    const CellLayout& getCellLayout() const { return layout; }
+    // Wall masks indexed by getCellLayout().index(x, y); padding slots are AllWalls
+    const uint8_t* layoutMasks() const { return layout.isRowMajor() ? grid.data() : layoutGrid.data(); }
+    unsigned int getSeed() const { return seed; }  // seed of the last generation
+    uint64_t getStream() const { return stream; }
+    
+    // Weight layer. Entering a cell costs its weight; unweighted mazes cost
+    // 1 per cell. setWeight enables the layer on first use and widens it to
+    // 16 bits when a weight above 255 arrives. Weights survive regeneration.
+    WeightFormat getWeightFormat() const { return weightFormat; }
+    bool hasWeights() const { return weightFormat != WeightFormat::None; }
+    void enableWeights(WeightFormat format);
+    void clearWeights();
+    int getWeight(int x, int y) const {
+        size_t i = static_cast<size_t>(y) * width + x;
+        switch (weightFormat) {
+            case WeightFormat::UInt8: return weights8[i];
+            case WeightFormat::UInt16: return weights16[i];
+            case WeightFormat::None: break;
+        }
+        return 1;
+    }
+    void setWeight(int x, int y, int weight);   // clamped to 1..65535
+    // Uniform random weights in 1..maxWeight, reproducible from seed
+    void fillRandomWeights(int maxWeight, unsigned int seed);
+    
+    // Set or clear the wall on one side of a cell, and the matching side of
+    // its neighbour. Direction as in hasWall.
+    void setWall(int x, int y, int direction, bool present);
+    // Flip that wall on both sides; returns whether it is now present.
+    // Border walls are left alone (and reported present).
+    bool toggleWall(int x, int y, int direction);
+    
+    // 64-bit content hash of size, walls and weights, kept current by every
+    // mutation (O(1) per changed wall). Equal mazes always match; different
+    // mazes collide with negligible probability.
+    uint64_t fingerprint() const;
     
     // Check if cell has wall in direction
     bool hasWall(int x, int y, int direction) const;
@@ -0,0 +1,232 @@
+#include "mazeanalytics.h"
+#include "mazeutil.h"
+#include "tracer.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Vertical run state of one column inside one stripe, for joining stripes
+struct ColumnRun {
+    int head = 0;             // run starting at the stripe's first row
+    int tail = 0;             // run ending at the stripe's last row
+    bool whole = true;        // the column is one run from top to bottom
+    bool linkedAbove = false; // first row opens upward into the previous stripe
+};
+
+struct StripeResult {
+    long long passages = 0;
+    long long degrees[5] = {0, 0, 0, 0, 0};
+    int longest = 0;
+    std::vector<ColumnRun> columns;
+};
+
+// Masks of cells x..x+7 of a row as one word, byte k for cell x + k. Cells
+// past either end of the row, or rows past the maze (row == nullptr), read
+// as closed.
+uint64_t loadMasks(const uint8_t* row, int width, int x) {
+    uint8_t bytes[8];
+    std::memset(bytes, AllWalls, sizeof(bytes));
+    int from = std::max(x, 0), to = std::min(x + 8, width);
+    if (row && to > from) std::memcpy(bytes + (from - x), row + from, to - from);
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+void analyzeStripe(const uint8_t* masks, int width, int height, int y0, int y1, StripeResult& out) {
+    out.columns.assign(width, ColumnRun());
+    std::vector<int> run(width, 0);   // vertical run ending at the current row
+
+    for (int y = y0; y < y1; y++) {
+        const uint8_t* row = masks + static_cast<size_t>(y) * width;
+        const uint8_t* above = y > 0 ? row - width : nullptr;
+        const uint8_t* below = y + 1 < height ? row + width : nullptr;
+
+        int horizontal = 0;
+        for (int x = 0; x < width; x += 8) {
+            int n = std::min(8, width - x);
+
+            // A side is open only when the neighbour's matching side is open
+            // too, as in validateMaze; the border and padding cells read as
+            // closed neighbours, so they never open
+            uint64_t closed = loadMasks(row, width, x);
+            closed |= (loadMasks(above, width, x) & (WallBottom * LowBytes)) >> 2;
+            closed |= (loadMasks(row, width, x + 1) & (WallLeft * LowBytes)) >> 2;
+            closed |= (loadMasks(below, width, x) & (WallTop * LowBytes)) << 2;
+            closed |= (loadMasks(row, width, x - 1) & (WallRight * LowBytes)) << 2;
+            uint64_t open = ~closed & (AllWalls * LowBytes);
+
+            // Right and bottom openings count every passage exactly once
+            out.passages += popcount64(open & (WallRight * LowBytes)) + popcount64(open & (WallBottom * LowBytes));
+
+            // Per-byte popcount of the open nibble is the cell's degree
+            uint64_t degree = (open & (0x55 * LowBytes)) + ((open >> 1) & (0x55 * LowBytes));
+            degree = (degree & (0x33 * LowBytes)) + ((degree >> 2) & (0x33 * LowBytes));
+            for (int k = 0; k < 8; k++) {
+                out.degrees[(degree >> (8 * k)) & 0xff]++;
+            }
+            out.degrees[0] -= 8 - n;
+
+            // From here a set bit means an opening, not a wall
+            uint8_t bytes[8];
+            std::memcpy(bytes, &open, sizeof(open));
+            for (int k = 0; k < n; k++) {
+                int column = x + k;
+
+                // Horizontal run through this cell, cut where the right side is closed
+                horizontal++;
+                out.longest = std::max(out.longest, horizontal);
+                if (!(bytes[k] & WallRight)) horizontal = 0;
+
+                // Vertical run, joined to the row above when open upward
+                ColumnRun& state = out.columns[column];
+                bool up = bytes[k] & WallTop;
+                if (y == y0) {
+                    state.linkedAbove = up;
+                    run[column] = 1;
+                } else if (up) {
+                    run[column]++;
+                } else {
+                    run[column] = 1;
+                    state.whole = false;
+                }
+                if (state.whole) state.head = run[column];
+                out.longest = std::max(out.longest, run[column]);
+            }
+        }
+    }
+
+    for (int x = 0; x < width; x++) {
+        out.columns[x].tail = run[x];
+    }
+}
+
+// Neighbour of cell across direction when the wall between them is open
+// on both sides, else -1
+int openNeighbor(const uint8_t* masks, int width, int height, int cell, int direction) {
+    int x = cell % width, y = cell / width;
+    int next;
+    switch (direction) {
+        case 0: next = y > 0 ? cell - width : -1; break;
+        case 1: next = x + 1 < width ? cell + 1 : -1; break;
+        case 2: next = y + 1 < height ? cell + width : -1; break;
+        default: next = x > 0 ? cell - 1 : -1; break;
+    }
+    if (next < 0 || (masks[cell] & (1 << direction)) || (masks[next] & (1 << ((direction + 2) % 4)))) return -1;
+    return next;
+}
+
+// BFS over the masks from source; fills dist (cells reached must be -1
+// beforehand) and returns the farthest cell reached
+int sweep(const uint8_t* masks, int width, int height, int source,
+          std::vector<int>& dist, std::vector<int>& queue) {
+    queue.clear();
+    queue.push_back(source);
+    dist[source] = 0;
+    int farthest = source;
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        int cell = queue[head];
+        if (dist[cell] > dist[farthest]) farthest = cell;
+
+        for (int direction = 0; direction < 4; direction++) {
+            int next = openNeighbor(masks, width, height, cell, direction);
+            if (next >= 0 && dist[next] < 0) {
+                dist[next] = dist[cell] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    return farthest;
+}
+
+} // namespace
+
+MazeMetrics analyzeMaze(const Maze& maze, int threads) {
+    TRACE_SCOPE("analytics", "analyzeMaze");
+    MazeMetrics metrics;
+    int width = maze.getWidth(), height = maze.getHeight();
+    const uint8_t* masks = maze.wallMasks();
+    metrics.cells = static_cast<long long>(width) * height;
+    if (metrics.cells == 0) return metrics;
+
+    int stripeCount = std::clamp(resolveThreads(threads), 1, height);
+
+    // Local pass: one stripe of rows per thread
+    std::vector<StripeResult> stripes(stripeCount);
+    {
+        TRACE_SCOPE("analytics", "stripe pass");
+        forEachStripe(stripeCount, height, [&](int s, int y0, int y1) {
+            analyzeStripe(masks, width, height, y0, y1, stripes[s]);
+        });
+    }
+
+    std::vector<int> carry(width, 0);
+    for (const StripeResult& stripe : stripes) {
+        metrics.passages += stripe.passages;
+        for (int d = 0; d < 5; d++) metrics.degreeHistogram[d] += stripe.degrees[d];
+        metrics.longestCorridor = std::max(metrics.longestCorridor, stripe.longest);
+
+        // Vertical runs that cross the stripe border
+        for (int x = 0; x < width; x++) {
+            const ColumnRun& column = stripe.columns[x];
+            if (column.linkedAbove) {
+                int joined = carry[x] + column.head;
+                metrics.longestCorridor = std::max(metrics.longestCorridor, joined);
+                carry[x] = column.whole ? joined : column.tail;
+            } else {
+                carry[x] = column.tail;
+            }
+        }
+    }
+    metrics.deadEnds = metrics.degreeHistogram[1];
+    metrics.junctions = metrics.degreeHistogram[3] + metrics.degreeHistogram[4];
+
+    // First sweep from the start corner gives the solution and one end of a long path
+    TRACE_SCOPE("analytics", "distance sweeps");
+    std::vector<int> dist(metrics.cells, -1);
+    std::vector<int> queue;
+    queue.reserve(metrics.cells);
+    int end = static_cast<int>(metrics.cells - 1);
+    int farthest = sweep(masks, width, height, 0, dist, queue);
+
+    if (dist[end] >= 0) {
+        metrics.solvable = true;
+        metrics.solutionLength = dist[end] + 1;
+
+        // Walk back downhill from the end, counting direction changes. The
+        // sweep used the same passages, so every cell but the start has a
+        // neighbour one step closer; stop rather than spin if not.
+        int cell = end, lastStep = 0;
+        while (cell != 0) {
+            int previous = -1;
+            for (int direction = 0; direction < 4 && previous < 0; direction++) {
+                int next = openNeighbor(masks, width, height, cell, direction);
+                if (next >= 0 && dist[next] == dist[cell] - 1) previous = next;
+            }
+            if (previous < 0) break;
+            int step = previous - cell;
+            if (lastStep != 0 && step != lastStep) metrics.solutionTurns++;
+            lastStep = step;
+            cell = previous;
+        }
+    }
+
+    // Components: everything the first sweep missed, region by region
+    metrics.components = 1;
+    for (int cell = 0; cell < end + 1; cell++) {
+        if (dist[cell] < 0) {
+            sweep(masks, width, height, cell, dist, queue);
+            metrics.components++;
+        }
+    }
+    metrics.cycles = metrics.passages - metrics.cells + metrics.components;
+
+    // Second sweep from the far end; exact diameter when the maze is a tree
+    std::fill(dist.begin(), dist.end(), -1);
+    int other = sweep(masks, width, height, farthest, dist, queue);
+    metrics.diameterEstimate = dist[other];
+    return metrics;
+}
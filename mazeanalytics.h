@@ -0,0 +1,30 @@
+#ifndef MAZEANALYTICS_H
+#define MAZEANALYTICS_H
+
+#include "maze.h"
+
+// Structural grade of one maze. Degrees count passages open on both sides
+// (walls on the outer border never count as open), as in validateMaze.
+struct MazeMetrics {
+    long long cells = 0;
+    long long passages = 0;           // open walls between two cells, each once
+    long long degreeHistogram[5] = {0, 0, 0, 0, 0};
+    long long deadEnds = 0;           // degree 1
+    long long junctions = 0;          // degree 3 or 4
+    int longestCorridor = 0;          // longest straight run of connected cells
+    long long components = 0;         // connected regions
+    long long cycles = 0;             // independent loops: passages - cells + components
+    int diameterEstimate = 0;         // double-sweep BFS, a lower bound (exact for perfect mazes)
+
+    // Corner-to-corner solution, from the first BFS sweep
+    bool solvable = false;
+    int solutionLength = 0;           // cells on the shortest path
+    int solutionTurns = 0;            // direction changes along it
+};
+
+// Computes every metric in one pass over the packed wall masks, plus two
+// BFS sweeps for distances. The local pass runs over row stripes on up to
+// threads threads (1 = inline, 0 = one per hardware thread).
+MazeMetrics analyzeMaze(const Maze& maze, int threads = 1);
+
+#endif // MAZEANALYTICS_H
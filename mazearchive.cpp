@@ -0,0 +1,230 @@
+#include "mazearchive.h"
+#include "mazeio.h"
+#include "mazeutil.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char magic[4] = {'M', 'Z', 'A', 'R'};
+const uint32_t formatVersion = 1;
+const size_t recordHeaderSize = 8 + 4 * 4 + 1 + 4 * 3;
+
+void putU32(std::string& out, uint32_t value) {
+    char bytes[4] = {
+        static_cast<char>(value), static_cast<char>(value >> 8),
+        static_cast<char>(value >> 16), static_cast<char>(value >> 24)
+    };
+    out.append(bytes, 4);
+}
+
+void putU64(std::string& out, uint64_t value) {
+    putU32(out, static_cast<uint32_t>(value));
+    putU32(out, static_cast<uint32_t>(value >> 32));
+}
+
+uint32_t getU32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t getU64(const unsigned char* p) {
+    return getU32(p) | (static_cast<uint64_t>(getU32(p + 4)) << 32);
+}
+
+// Move code from one path cell to the next (same numbering as Maze::hasWall)
+unsigned char moveCode(std::pair<int, int> from, std::pair<int, int> to) {
+    if (to.second < from.second) return 0;
+    if (to.first > from.first) return 1;
+    if (to.second > from.second) return 2;
+    return 3;
+}
+
+} // namespace
+
+void encodeArchiveRecord(std::string& out, uint64_t index, const Maze& maze, int cycles,
+                         const PathResult* solution) {
+    int width = maze.getWidth(), height = maze.getHeight();
+    bool solved = solution != nullptr;
+    bool found = solved && solution->found && !solution->path.empty();
+    size_t pathCells = found ? solution->path.size() : 0;
+
+    putU64(out, index);
+    putU32(out, maze.getSeed());
+    putU32(out, static_cast<uint32_t>(width));
+    putU32(out, static_cast<uint32_t>(height));
+    putU32(out, static_cast<uint32_t>(cycles));
+    out.push_back(static_cast<char>((solved ? 1 : 0) | (found ? 2 : 0)));
+    putU32(out, found ? static_cast<uint32_t>(solution->path.front().first) : 0);
+    putU32(out, found ? static_cast<uint32_t>(solution->path.front().second) : 0);
+    putU32(out, static_cast<uint32_t>(pathCells));
+
+    // Walls, two cells a byte, written in place
+    size_t cells = static_cast<size_t>(width) * height;
+    size_t base = out.size();
+    out.resize(base + (cells + 1) / 2);
+    packWallMasks(maze.wallMasks(), cells, reinterpret_cast<unsigned char*>(&out[base]));
+
+    if (pathCells > 1) {
+        size_t moves = pathCells - 1;
+        base = out.size();
+        out.resize(base + (moves + 3) / 4, '\0');
+        for (size_t i = 0; i < moves; i++) {
+            unsigned char code = moveCode(solution->path[i], solution->path[i + 1]);
+            out[base + i / 4] |= static_cast<char>(code << (2 * (i % 4)));
+        }
+    }
+}
+
+MazeArchiveWriter::MazeArchiveWriter(const std::string& p, long long size)
+    : prefix(p), shardSize(size > 0 ? size : 1), shards(0), inShard(0), bytes(0) {}
+
+std::string MazeArchiveWriter::shardName(const std::string& prefix, int shard) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "-%05d.mzar", shard);
+    return prefix + suffix;
+}
+
+bool MazeArchiveWriter::openShard() {
+    if (out.is_open() && !close()) return false;
+
+    std::string name = shardName(prefix, shards);
+    out.open(name, std::ios::binary);
+    if (!out) {
+        error = "cannot open " + name + " for writing";
+        return false;
+    }
+
+    std::string header(magic, 4);
+    putU32(header, formatVersion);
+    putU32(header, static_cast<uint32_t>(shards));
+    out.write(header.data(), header.size());
+    bytes += static_cast<long long>(header.size());
+    shards++;
+    inShard = 0;
+    return true;
+}
+
+bool MazeArchiveWriter::append(const char* data, size_t size) {
+    if (!out.is_open() || inShard >= shardSize) {
+        if (!openShard()) return false;
+    }
+    out.write(data, size);
+    if (!out) {
+        error = "failed writing " + shardName(prefix, shards - 1);
+        return false;
+    }
+    bytes += static_cast<long long>(size);
+    inShard++;
+    return true;
+}
+
+bool MazeArchiveWriter::close() {
+    if (!out.is_open()) return true;
+    out.close();
+    if (!out) {
+        error = "failed writing " + shardName(prefix, shards - 1);
+        return false;
+    }
+    return true;
+}
+
+bool readArchiveShard(const std::string& filename, const std::function<bool(ArchiveRecord&)>& visit,
+                      std::string* error) {
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in) {
+        setError(error, "cannot open " + filename);
+        return false;
+    }
+    // Every size in a record is checked against what is left of the file
+    // before anything is allocated for it
+    uint64_t remaining = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+
+    unsigned char header[12];
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) || std::memcmp(header, magic, 4) != 0) {
+        setError(error, filename + " is not a maze archive");
+        return false;
+    }
+    if (getU32(header + 4) != formatVersion) {
+        setError(error, filename + " has an unsupported format version");
+        return false;
+    }
+    remaining -= sizeof(header);
+
+    std::vector<unsigned char> buffer;
+    unsigned char fields[recordHeaderSize];
+    while (remaining > 0) {
+        if (remaining < sizeof(fields) || !in.read(reinterpret_cast<char*>(fields), sizeof(fields))) {
+            setError(error, filename + " is truncated");
+            return false;
+        }
+        remaining -= sizeof(fields);
+
+        ArchiveRecord record;
+        record.index = getU64(fields);
+        record.seed = getU32(fields + 8);
+        uint32_t width = getU32(fields + 12), height = getU32(fields + 16);
+        record.cycles = static_cast<int>(getU32(fields + 20));
+        record.solved = fields[24] & 1;
+        record.found = fields[24] & 2;
+        uint32_t startX = getU32(fields + 25), startY = getU32(fields + 29);
+        uint32_t pathCells = getU32(fields + 33);
+
+        if (width == 0 || height == 0 || static_cast<uint64_t>(width) * height > 0x7fffffff) {
+            setError(error, filename + " has a record with an invalid size");
+            return false;
+        }
+        uint64_t cells = static_cast<uint64_t>(width) * height;
+        // A shortest path visits a cell at most once
+        if (pathCells > cells || (pathCells > 0 && (startX >= width || startY >= height))) {
+            setError(error, filename + " has a record with an invalid path");
+            return false;
+        }
+
+        uint64_t moves = pathCells > 1 ? pathCells - 1 : 0;
+        uint64_t bodySize = (cells + 1) / 2 + (moves + 3) / 4;
+        if (bodySize > remaining) {
+            setError(error, filename + " is truncated");
+            return false;
+        }
+        buffer.resize(bodySize);
+        if (!in.read(reinterpret_cast<char*>(buffer.data()), buffer.size())) {
+            setError(error, "failed reading " + filename);
+            return false;
+        }
+        remaining -= bodySize;
+
+        record.maze = std::make_unique<Maze>(static_cast<int>(width), static_cast<int>(height));
+        uint64_t cell = 0;
+        for (uint32_t row = 0; row < height; row++) {
+            for (uint32_t column = 0; column < width; column++, cell++) {
+                unsigned char byte = buffer[cell / 2];
+                unsigned char bits = cell % 2 == 0 ? (byte & 0x0f) : (byte >> 4);
+                record.maze->setCell(static_cast<int>(column), static_cast<int>(row), unpackCell(bits));
+            }
+        }
+
+        if (pathCells > 0) {
+            const unsigned char* packedMoves = buffer.data() + (cells + 1) / 2;
+            int x = static_cast<int>(startX), y = static_cast<int>(startY);
+            record.path.reserve(pathCells);
+            record.path.push_back({x, y});
+            for (uint64_t i = 0; i < moves; i++) {
+                switch ((packedMoves[i / 4] >> (2 * (i % 4))) & 3) {
+                    case 0: y--; break;
+                    case 1: x++; break;
+                    case 2: y++; break;
+                    case 3: x--; break;
+                }
+                if (x < 0 || y < 0 || x >= static_cast<int>(width) || y >= static_cast<int>(height)) {
+                    setError(error, filename + " has a record whose path leaves the maze");
+                    return false;
+                }
+                record.path.push_back({x, y});
+            }
+        }
+
+        if (!visit(record)) return true;
+    }
+    return true;
+}
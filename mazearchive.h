@@ -0,0 +1,70 @@
+#ifndef MAZEARCHIVE_H
+#define MAZEARCHIVE_H
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "maze.h"
+#include "pathfinder.h"
+
+// Sharded archive for bulk datasets. Shard files are named PREFIX-NNNNN.mzar
+// and each one holds "MZAR", a format version and its shard number, followed
+// by records back to back until end of file:
+//   u64 index, u32 seed, u32 width, u32 height, u32 cycles,
+//   u8 flags (1 = solved, 2 = path found), u32 start x, u32 start y,
+//   u32 path cells, the walls packed as in mazeio (two cells a byte) and,
+//   when solved, the path as 2-bit moves (0 = up, 1 = right, 2 = down,
+//   3 = left), four a byte.
+// Integers are little-endian. Maze index i with the stored seed is
+// reproduced by Maze::generateMaze(cycles, seed, i).
+struct ArchiveRecord {
+    uint64_t index = 0;
+    unsigned int seed = 0;
+    int cycles = 0;
+    bool solved = false;
+    bool found = false;
+    std::unique_ptr<Maze> maze;
+    std::vector<std::pair<int, int>> path;
+};
+
+// Appends one record to out; solution may be nullptr
+void encodeArchiveRecord(std::string& out, uint64_t index, const Maze& maze, int cycles,
+                         const PathResult* solution);
+
+// Writes encoded records, starting a new shard every shardSize records
+class MazeArchiveWriter {
+private:
+    std::string prefix;
+    long long shardSize;
+    std::ofstream out;
+    int shards;
+    long long inShard;
+    long long bytes;
+    std::string error;
+
+    bool openShard();
+
+public:
+    MazeArchiveWriter(const std::string& prefix, long long shardSize);
+
+    bool append(const char* data, size_t size);
+    bool close();
+
+    int shardCount() const { return shards; }
+    long long bytesWritten() const { return bytes; }
+    const std::string& lastError() const { return error; }
+
+    static std::string shardName(const std::string& prefix, int shard);
+};
+
+// Decodes every record of one shard in order; visit returns false to stop.
+// Record sizes are checked against the file and paths against the maze
+// bounds, so a corrupt shard fails with an error instead of allocating.
+bool readArchiveShard(const std::string& filename, const std::function<bool(ArchiveRecord&)>& visit,
+                      std::string* error = nullptr);
+
+#endif // MAZEARCHIVE_H
@@ -0,0 +1,45 @@
+#include "mazearena.h"
+
+void* MazeArena::OverflowCounter::do_allocate(size_t n, size_t alignment) {
+    void* p = upstream->allocate(n, alignment);
+    bytes += n;
+    allocations++;
+    return p;
+}
+
+void MazeArena::OverflowCounter::do_deallocate(void* p, size_t n, size_t alignment) {
+    upstream->deallocate(p, n, alignment);
+}
+
+bool MazeArena::OverflowCounter::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+MazeArena::MazeArena(size_t initialBytes, std::pmr::memory_resource* up)
+    : upstream(up), block(nullptr), blockSize(initialBytes) {
+    if (blockSize == 0) blockSize = 1;
+    block = upstream->allocate(blockSize, alignof(std::max_align_t));
+    overflow.upstream = upstream;
+    monotonic.emplace(block, blockSize, &overflow);
+}
+
+MazeArena::~MazeArena() {
+    monotonic.reset();
+    upstream->deallocate(block, blockSize, alignof(std::max_align_t));
+}
+
+void MazeArena::reset() {
+    // Destroying the monotonic resource hands its overflow chunks back upstream
+    monotonic.reset();
+
+    if (overflow.bytes > 0) {
+        size_t grown = blockSize + overflow.bytes;
+        upstream->deallocate(block, blockSize, alignof(std::max_align_t));
+        block = upstream->allocate(grown, alignof(std::max_align_t));
+        blockSize = grown;
+    }
+    overflow.bytes = 0;
+    overflow.allocations = 0;
+
+    monotonic.emplace(block, blockSize, &overflow);
+}
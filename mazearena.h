@@ -0,0 +1,55 @@
+#ifndef MAZEARENA_H
+#define MAZEARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include "memorytracker.h"
+
+// Monotonic arena for per-run temporaries: generation wall lists, Union-Find
+// arrays, solver scratch and, optionally, PathResult vectors. Deallocation is
+// a no-op; reset() frees everything at once. When a run spills past the
+// arena's block, the next reset() grows the block to cover it, so repeated
+// runs of the same size settle into zero upstream allocations.
+// Not thread-safe: give each thread its own arena.
+class MazeArena {
+private:
+    // Sits between the monotonic resource and the tracked upstream and
+    // records how much a run needed beyond the main block
+    class OverflowCounter : public std::pmr::memory_resource {
+    public:
+        std::pmr::memory_resource* upstream = nullptr;
+        size_t bytes = 0;
+        long long allocations = 0;
+
+    protected:
+        void* do_allocate(size_t n, size_t alignment) override;
+        void do_deallocate(void* p, size_t n, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    std::pmr::memory_resource* upstream;
+    void* block;
+    size_t blockSize;
+    OverflowCounter overflow;
+    std::optional<std::pmr::monotonic_buffer_resource> monotonic;
+
+public:
+    explicit MazeArena(size_t initialBytes = 64 * 1024,
+                       std::pmr::memory_resource* up = MemoryTracker::resource(MemorySubsystem::Arena));
+    ~MazeArena();
+
+    MazeArena(const MazeArena&) = delete;
+    MazeArena& operator=(const MazeArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*monotonic; }
+
+    // Invalidates everything allocated from resource() since the last reset
+    void reset();
+
+    size_t capacity() const { return blockSize; }
+    // Upstream allocations made since the last reset (0 once the arena has settled)
+    long long overflowAllocations() const { return overflow.allocations; }
+};
+
+#endif // MAZEARENA_H
@@ -0,0 +1,398 @@
+// Reproducible throughput benchmarks for the maze engine. Every maze is
+// generated from a fixed seed, so runs on the same machine are comparable
+// and a stored JSON baseline can flag regressions.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "maze.h"
+#include "mazeanalytics.h"
+#include "mazearena.h"
+#include "mazetext.h"
+#include "mazevalidator.h"
+#include "pathfinder.h"
+#include "solutioncache.h"
+#include "unionfind.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+    std::vector<int> sizes = {64, 256, 1024, 4096};
+    std::vector<double> densities = {0.0, 0.05};  // extraCycles as a fraction of cells
+    int warmup = 1;
+    int repetitions = 5;
+    unsigned int seed = 12345;
+    std::string filter;         // only run benchmarks whose name contains this
+    std::string jsonPath;
+    std::string baselinePath;
+    double threshold = 0.10;    // allowed median slowdown against the baseline
+    bool counters = false;      // one extra repetition under hardware counters
+};
+
+// Last-level cache and data TLB misses of this thread, from perf_event on
+// Linux. A counter the kernel or the hardware refuses (containers, VMs
+// without a PMU) reads as -1.
+class MissCounters {
+private:
+    int cacheFd = -1;
+    int tlbFd = -1;
+
+#if defined(__linux__)
+    static int open(uint32_t type, uint64_t config) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    static long long read(int fd) {
+        long long value = 0;
+        if (fd < 0 || ::read(fd, &value, sizeof(value)) != sizeof(value)) return -1;
+        return value;
+    }
+
+    static void control(int fd, unsigned long request) {
+        if (fd >= 0) ioctl(fd, request, 0);
+    }
+#endif
+
+public:
+    MissCounters() {
+#if defined(__linux__)
+        cacheFd = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        tlbFd = open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+                                         (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#endif
+    }
+
+    ~MissCounters() {
+#if defined(__linux__)
+        if (cacheFd >= 0) close(cacheFd);
+        if (tlbFd >= 0) close(tlbFd);
+#endif
+    }
+
+    MissCounters(const MissCounters&) = delete;
+    MissCounters& operator=(const MissCounters&) = delete;
+
+    // Runs body with the counters on; returns {cache misses, TLB misses}
+    std::pair<long long, long long> measure(const std::function<void()>& body) {
+#if defined(__linux__)
+        for (int fd : {cacheFd, tlbFd}) {
+            control(fd, PERF_EVENT_IOC_RESET);
+            control(fd, PERF_EVENT_IOC_ENABLE);
+        }
+        body();
+        for (int fd : {cacheFd, tlbFd}) control(fd, PERF_EVENT_IOC_DISABLE);
+        return {read(cacheFd), read(tlbFd)};
+#else
+        body();
+        return {-1, -1};
+#endif
+    }
+};
+
+struct BenchResult {
+    std::string name;
+    long long items = 0;        // work units per repetition (cells, unions, ...)
+    std::vector<long long> samples;
+    long long cacheMisses = -1; // from the --counters repetition; -1 = not measured
+    long long tlbMisses = -1;
+
+    long long percentile(double p) const {
+        std::vector<long long> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[index];
+    }
+
+    double mean() const {
+        double total = 0;
+        for (long long s : samples) total += s;
+        return total / samples.size();
+    }
+
+    double itemsPerSecond() const {
+        long long median = percentile(0.5);
+        return median > 0 ? items * 1e9 / median : 0.0;
+    }
+};
+
+template <typename T>
+std::vector<T> parseList(const std::string& text) {
+    std::vector<T> values;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        std::istringstream field(item);
+        T value;
+        if (field >> value) values.push_back(value);
+    }
+    return values;
+}
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--sizes") options.sizes = parseList<int>(value);
+        else if (arg == "--densities") options.densities = parseList<double>(value);
+        else if (arg == "--warmup") options.warmup = std::atoi(value.c_str());
+        else if (arg == "--reps") options.repetitions = std::atoi(value.c_str());
+        else if (arg == "--seed") options.seed = static_cast<unsigned int>(std::strtoul(value.c_str(), nullptr, 10));
+        else if (arg == "--filter") options.filter = value;
+        else if (arg == "--json") options.jsonPath = value;
+        else if (arg == "--baseline") options.baselinePath = value;
+        else if (arg == "--threshold") options.threshold = std::atof(value.c_str());
+        else if (arg == "--counters") options.counters = value != "0";
+        else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    return !options.sizes.empty() && options.repetitions > 0;
+}
+
+class BenchRunner {
+private:
+    const BenchOptions& options;
+    std::vector<BenchResult> results;
+    MissCounters counters;
+
+public:
+    explicit BenchRunner(const BenchOptions& o) : options(o) {}
+
+    void run(const std::string& name, long long items, const std::function<void()>& body) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+
+        BenchResult result;
+        result.name = name;
+        result.items = items;
+
+        for (int i = 0; i < options.warmup; i++) {
+            body();
+        }
+        for (int i = 0; i < options.repetitions; i++) {
+            auto start = Clock::now();
+            body();
+            result.samples.push_back(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        }
+
+        if (options.counters) {
+            std::tie(result.cacheMisses, result.tlbMisses) = counters.measure(body);
+        }
+
+        std::cout << name << ": median " << result.percentile(0.5) / 1e6 << " ms, p90 "
+                  << result.percentile(0.9) / 1e6 << " ms, " << result.itemsPerSecond() / 1e6
+                  << " M items/s";
+        if (options.counters) {
+            auto count = [](long long n) { return n < 0 ? std::string("n/a") : std::to_string(n); };
+            std::cout << ", cache misses " << count(result.cacheMisses)
+                      << ", dTLB misses " << count(result.tlbMisses);
+        }
+        std::cout << "\n";
+        results.push_back(result);
+    }
+
+    const std::vector<BenchResult>& getResults() const { return results; }
+};
+
+void writeJson(const std::string& path, const BenchOptions& options, const std::vector<BenchResult>& results) {
+    std::ofstream out(path);
+    out << "{\n  \"seed\": " << options.seed << ",\n  \"repetitions\": " << options.repetitions
+        << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"items\": " << r.items
+            << ", \"min_ns\": " << r.percentile(0.0)
+            << ", \"median_ns\": " << r.percentile(0.5)
+            << ", \"p90_ns\": " << r.percentile(0.9)
+            << ", \"p99_ns\": " << r.percentile(0.99)
+            << ", \"max_ns\": " << r.percentile(1.0)
+            << ", \"mean_ns\": " << static_cast<long long>(r.mean())
+            << ", \"items_per_sec\": " << static_cast<long long>(r.itemsPerSecond())
+            << ", \"cache_misses\": " << r.cacheMisses
+            << ", \"dtlb_misses\": " << r.tlbMisses << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Reads name -> median_ns from a file written by writeJson
+std::map<std::string, long long> readBaseline(const std::string& path) {
+    std::map<std::string, long long> medians;
+    std::ifstream in(path);
+    std::string line;
+    const std::string nameKey = "\"name\": \"";
+    const std::string medianKey = "\"median_ns\": ";
+
+    while (std::getline(in, line)) {
+        size_t name = line.find(nameKey);
+        size_t median = line.find(medianKey);
+        if (name == std::string::npos || median == std::string::npos) continue;
+
+        name += nameKey.size();
+        size_t nameEnd = line.find('"', name);
+        medians[line.substr(name, nameEnd - name)] =
+            std::atoll(line.c_str() + median + medianKey.size());
+    }
+    return medians;
+}
+
+// Prints a comparison table; returns the number of regressions
+int compareToBaseline(const BenchOptions& options, const std::vector<BenchResult>& results) {
+    std::map<std::string, long long> baseline = readBaseline(options.baselinePath);
+    if (baseline.empty()) {
+        std::cerr << "No benchmarks found in baseline " << options.baselinePath << "\n";
+        return 0;
+    }
+
+    int regressions = 0;
+    std::cout << "\nBaseline comparison (threshold " << options.threshold * 100 << "%):\n";
+    for (const BenchResult& r : results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second <= 0) continue;
+
+        double change = static_cast<double>(r.percentile(0.5)) / it->second - 1.0;
+        bool regressed = change > options.threshold;
+        if (regressed) regressions++;
+        std::cout << "  " << (regressed ? "REGRESSION " : "ok         ") << r.name << ": "
+                  << (change >= 0 ? "+" : "") << change * 100 << "%\n";
+    }
+    return regressions;
+}
+
+std::string sizeName(int size) {
+    return std::to_string(size) + "x" + std::to_string(size);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: mazebench [--sizes 64,256,1024] [--densities 0,0.05] [--warmup N] [--reps N]\n"
+                     "                 [--seed S] [--filter TEXT] [--json FILE]\n"
+                     "                 [--baseline FILE] [--threshold 0.10] [--counters 1]\n";
+        return 2;
+    }
+
+    BenchRunner runner(options);
+
+    for (int size : options.sizes) {
+        long long cells = static_cast<long long>(size) * size;
+
+        // Union-Find on its own: random unions over every cell, seeded
+        std::vector<std::pair<int, int>> pairs(cells);
+        std::mt19937 rng(options.seed);
+        std::uniform_int_distribution<int> pick(0, static_cast<int>(cells - 1));
+        for (auto& p : pairs) p = {pick(rng), pick(rng)};
+
+        runner.run("unionfind/" + sizeName(size), cells, [&] {
+            UnionFind uf(static_cast<int>(cells));
+            for (auto [a, b] : pairs) uf.unite(a, b);
+        });
+
+        for (double density : options.densities) {
+            int cycles = static_cast<int>(cells * density);
+            std::string suffix = sizeName(size) + "/cycles=" + std::to_string(density).substr(0, 4);
+
+            Maze maze(size, size);
+            runner.run("generate/" + suffix, cells, [&] {
+                maze.generateMaze(cycles, options.seed);
+            });
+
+            // Solvers always run on the same seeded maze
+            maze.generateMaze(cycles, options.seed);
+            PathFinder pf(&maze, 0, 0, size - 1, size - 1);
+            runner.run("bfs/" + suffix, cells, [&] { pf.solveBFS(); });
+            runner.run("dfs/" + suffix, cells, [&] { pf.solveDFS(); });
+            runner.run("analyze/" + suffix, cells, [&] { analyzeMaze(maze, 1); });
+            runner.run("validate/" + suffix, cells, [&] { validateMaze(maze, 1); });
+
+            // ASCII import on one thread, from text already in memory
+            std::string text = formatTextMaze(maze, TextMazeStyle::Blocks);
+            runner.run("text-import/" + suffix, cells, [&] { parseTextMaze(text.data(), text.size(), nullptr, 1); });
+
+            // Repeat query through the solution cache: every timed run is a hit
+            SolutionCache cache;
+            runner.run("bfs-cached/" + suffix, cells, [&] {
+                cache.solve(maze, Algorithm::BFS, 0, 0, size - 1, size - 1);
+            });
+
+            // Dijkstra on random terrain: radix heap vs. binary heap
+            for (int maxWeight : {9, 255}) {
+                Maze weighted(size, size);
+                weighted.generateMaze(cycles, options.seed);
+                weighted.fillRandomWeights(maxWeight, options.seed);
+                PathFinder wpf(&weighted, 0, 0, size - 1, size - 1);
+                std::string name = suffix + "/weights=" + std::to_string(maxWeight);
+                runner.run("dijkstra-radix/" + name, cells, [&] { wpf.solveDijkstra(PriorityQueueKind::Radix); });
+                runner.run("dijkstra-binary/" + name, cells, [&] { wpf.solveDijkstra(PriorityQueueKind::Binary); });
+            }
+
+            // Whole generate + solve cycle: tracked heap vs. one reused arena
+            runner.run("cycle/heap/" + suffix, cells, [&] {
+                maze.generateMaze(cycles, options.seed);
+                PathFinder solver(&maze, 0, 0, size - 1, size - 1);
+                solver.solveBFS();
+            });
+            MazeArena arena;
+            runner.run("cycle/arena/" + suffix, cells, [&] {
+                arena.reset();
+                maze.generateMaze(cycles, options.seed, arena.resource());
+                PathFinder solver(&maze, 0, 0, size - 1, size - 1);
+                solver.setScratchResource(arena.resource());
+                solver.setResultResource(arena.resource());
+                solver.solveBFS();
+            });
+
+            // The same maze traversed in each cell layout
+            for (CellLayoutKind kind : {CellLayoutKind::RowMajor, CellLayoutKind::Morton, CellLayoutKind::Blocked}) {
+                std::string name = std::string(CellLayout::name(kind)) + "/" + suffix;
+                maze.setCellLayout(kind);
+                runner.run("layout/generate/" + name, cells, [&] { maze.generateMaze(cycles, options.seed); });
+                PathFinder solver(&maze, 0, 0, size - 1, size - 1);
+                runner.run("layout/bfs/" + name, cells, [&] { solver.solveBFS(); });
+                runner.run("layout/dfs/" + name, cells, [&] { solver.solveDFS(); });
+            }
+            maze.setCellLayout(CellLayoutKind::RowMajor);
+        }
+    }
+
+    if (!options.jsonPath.empty()) {
+        writeJson(options.jsonPath, options, runner.getResults());
+    }
+
+    if (!options.baselinePath.empty() && compareToBaseline(options, runner.getResults()) > 0) {
+        return 1;
+    }
+    return 0;
+}
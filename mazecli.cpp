@@ -0,0 +1,878 @@
+// Headless command-line front end for the maze engine. Links only the core
+// library (plus the exporter), so it starts instantly and needs no display.
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bulkgenerator.h"
+#include "maze.h"
+#include "mazeanalytics.h"
+#include "mazearchive.h"
+#include "mazeconnectivity.h"
+#include "mazeexporter.h"
+#include "mazeio.h"
+#include "mazereplay.h"
+#include "mazetext.h"
+#include "mazevalidator.h"
+#include "memorytracker.h"
+#include "pathfinder.h"
+#include "solverrace.h"
+#include "tracer.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string command;
+    std::string input;
+    std::string output;
+    std::string format = "json";
+    std::string algorithm;     // empty = bfs for solve, no overlay for export
+    int width = 50;
+    int height = 50;
+    int cycles = -1;        // -1 = width * height / 20, as in the GUI
+    int startX = 0, startY = 0;
+    int endX = -1, endY = -1;  // -1 = bottom-right corner
+    int cellSize = 4;
+    bool seeded = false;
+    unsigned int seed = 0;
+    bool memory = false;    // print per-subsystem memory after the command
+    bool verify = false;    // bulk: read the archive back and check every record
+    std::string tracePath;  // Chrome trace-event JSON written after the command
+    int maxWeight = 0;          // random cell weights 1..maxWeight, 0 = unweighted
+    long long count = 1000;     // bulk: number of mazes
+    int threads = 0;            // bulk: worker threads, 0 = all cores
+    long long shardSize = 10000;  // bulk: mazes per archive shard
+    std::string replayPath;     // replay file written by generate and solve
+    std::string scriptPath;     // edit: wall edits and connectivity queries
+    CellLayoutKind layout = CellLayoutKind::RowMajor;  // traversal layout for generation and solvers
+    TextMazeStyle textStyle = TextMazeStyle::Blocks;   // how .txt mazes are written
+};
+
+// One flat output row, printed as a JSON object or a CSV line
+class Record {
+private:
+    std::vector<std::pair<std::string, std::string>> fields;
+    std::vector<bool> quoted;
+
+    static std::string jsonString(const std::string& text) {
+        std::string out = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escape[8];
+                std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+                out += escape;
+            } else {
+                out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+    // RFC 4180: quote fields holding a separator, quote or line break
+    static std::string csvField(const std::string& text) {
+        if (text.find_first_of(",\"\r\n") == std::string::npos) return text;
+        std::string out = "\"";
+        for (char c : text) {
+            if (c == '"') out += '"';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+public:
+    Record& add(const std::string& key, const std::string& value) {
+        fields.push_back({key, value});
+        quoted.push_back(true);
+        return *this;
+    }
+
+    template <typename T>
+    Record& add(const std::string& key, T value) {
+        fields.push_back({key, std::to_string(value)});
+        quoted.push_back(false);
+        return *this;
+    }
+
+    Record& add(const std::string& key, bool value) {
+        fields.push_back({key, value ? "true" : "false"});
+        quoted.push_back(false);
+        return *this;
+    }
+
+    void print(const std::string& format, bool withHeader) const {
+        if (format == "csv") {
+            if (withHeader) {
+                for (size_t i = 0; i < fields.size(); i++) {
+                    std::cout << (i ? "," : "") << fields[i].first;
+                }
+                std::cout << "\n";
+            }
+            for (size_t i = 0; i < fields.size(); i++) {
+                std::cout << (i ? "," : "") << csvField(fields[i].second);
+            }
+            std::cout << "\n";
+            return;
+        }
+
+        std::cout << "{";
+        for (size_t i = 0; i < fields.size(); i++) {
+            std::cout << (i ? ", " : "") << "\"" << fields[i].first << "\": ";
+            if (quoted[i]) std::cout << jsonString(fields[i].second);
+            else std::cout << fields[i].second;
+        }
+        std::cout << "}\n";
+    }
+};
+
+void printUsage() {
+    std::cerr <<
+        "Usage: mazecli <command> [options]\n"
+        "\n"
+        "Commands:\n"
+        "  generate   Generate a maze (save it with --out)\n"
+        "  solve      Solve a generated or loaded maze\n"
+        "  report     Print structural facts about a maze\n"
+        "  validate   Check wall symmetry, connectivity and loop count (exit 3 if broken)\n"
+        "  export     Render a maze (and solution with --algorithm) to PNG or SVG\n"
+        "  race       Run every solver at once, one thread each (pinned when cores allow)\n"
+        "  bulk       Generate --count mazes on all cores into a sharded archive\n"
+        "  replay     Summarize a replay file (--in), optionally saving its maze (--out)\n"
+        "  edit       Apply a --script of wall edits and answer its connectivity queries\n"
+        "\n"
+        "Options:\n"
+        "  --in FILE            Load a maze file instead of generating one (.txt = text maze)\n"
+        "  --out FILE           Maze file (generate) or image file (export); .txt writes text\n"
+        "  --width N --height N Maze size for generation (default 50x50)\n"
+        "  --cycles N           Extra walls removed to create loops\n"
+        "  --seed S             Seed for reproducible generation\n"
+        "  --algorithm NAME     Solver name, or all (default bfs)\n"
+        "  --start X,Y --end X,Y  Endpoints (default corners)\n"
+        "  --format json|csv    Output format (default json)\n"
+        "  --cell-size N        Pixels per cell for export (default 4)\n"
+        "  --weights MAX        Random cell weights 1..MAX from the seed (for Dijkstra)\n"
+        "  --count N            Mazes to generate in bulk (default 1000)\n"
+        "  --threads N          Worker threads for bulk, report and validate (default: all cores)\n"
+        "  --shard-size N       Mazes per archive shard (default 10000)\n"
+        "  --verify             bulk: read the shards back and regenerate every maze to check it\n"
+        "  --replay FILE        Record the generation (and solve) as a replay file\n"
+        "  --script FILE        Edit script: open|close|toggle X Y DIR, query X1 Y1 X2 Y2\n"
+        "  --layout NAME        Cell layout for generation and solving: row, morton, blocked\n"
+        "  --text-style NAME    Style of .txt mazes written: blocks (default) or lines\n"
+        "  --memory             Also print tracked memory per subsystem and peak RSS\n"
+        "  --trace FILE         Record a Chrome trace-event timeline (view in Perfetto)\n";
+}
+
+bool parsePoint(const std::string& text, int& x, int& y) {
+    std::istringstream in(text);
+    char comma;
+    return static_cast<bool>(in >> x >> comma >> y) && comma == ',';
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    if (argc < 2) return false;
+    options.command = argv[1];
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--memory") {
+            options.memory = true;
+            continue;
+        }
+        if (arg == "--verify") {
+            options.verify = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--in") options.input = value;
+        else if (arg == "--out") options.output = value;
+        else if (arg == "--format") options.format = value;
+        else if (arg == "--algorithm") options.algorithm = value;
+        else if (arg == "--width") options.width = std::atoi(value.c_str());
+        else if (arg == "--height") options.height = std::atoi(value.c_str());
+        else if (arg == "--cycles") options.cycles = std::atoi(value.c_str());
+        else if (arg == "--cell-size") options.cellSize = std::atoi(value.c_str());
+        else if (arg == "--trace") options.tracePath = value;
+        else if (arg == "--weights") options.maxWeight = std::atoi(value.c_str());
+        else if (arg == "--count") options.count = std::atoll(value.c_str());
+        else if (arg == "--threads") options.threads = std::atoi(value.c_str());
+        else if (arg == "--shard-size") options.shardSize = std::atoll(value.c_str());
+        else if (arg == "--replay") options.replayPath = value;
+        else if (arg == "--script") options.scriptPath = value;
+        else if (arg == "--seed") {
+            options.seeded = true;
+            options.seed = static_cast<unsigned int>(std::strtoul(value.c_str(), nullptr, 10));
+        }
+        else if (arg == "--layout" && CellLayout::parse(value, options.layout)) {}
+        else if (arg == "--text-style" && (value == "blocks" || value == "lines")) {
+            options.textStyle = value == "lines" ? TextMazeStyle::Lines : TextMazeStyle::Blocks;
+        }
+        else if (arg == "--start" && parsePoint(value, options.startX, options.startY)) {}
+        else if (arg == "--end" && parsePoint(value, options.endX, options.endY)) {}
+        else {
+            std::cerr << "Unknown or malformed option: " << arg << " " << value << "\n";
+            return false;
+        }
+    }
+
+    if (options.format != "json" && options.format != "csv") {
+        std::cerr << "Unknown format: " << options.format << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Maze files by extension: .txt is a text maze, anything else the binary format
+std::unique_ptr<Maze> readMazeFile(const Options& options, std::string* error) {
+    if (isTextMazePath(options.input)) return loadTextMaze(options.input, error, options.threads);
+    return loadMaze(options.input, error);
+}
+
+bool writeMazeFile(const Maze& maze, const Options& options, std::string* error) {
+    if (isTextMazePath(options.output)) return saveTextMaze(maze, options.output, options.textStyle, error);
+    return saveMaze(maze, options.output, error);
+}
+
+// Loads --in, or generates a fresh maze; the generation time goes to record
+// Cells, including the padding of tiled layouts, are indexed with int
+// throughout, so mazes are capped at INT_MAX cells as in loadMaze
+bool checkCellCount(int width, int height, CellLayoutKind layout) {
+    if (static_cast<long long>(width) * height > INT_MAX || CellLayout(layout, width, height).size() > INT_MAX) {
+        std::cerr << "Maze too large: at most " << INT_MAX << " cells, including layout padding\n";
+        return false;
+    }
+    return true;
+}
+
+// Loop count for a generated maze; the default is width * height / 20
+int resolveCycles(const Options& options) {
+    if (options.cycles >= 0) return options.cycles;
+    return static_cast<int>(static_cast<long long>(options.width) * options.height / 20);
+}
+
+std::unique_ptr<Maze> obtainMaze(const Options& options, Record& record) {
+    if (!options.input.empty()) {
+        std::string error;
+        auto start = Clock::now();
+        std::unique_ptr<Maze> maze = readMazeFile(options, &error);
+        if (!maze) {
+            std::cerr << error << "\n";
+            return nullptr;
+        }
+        if (!checkCellCount(maze->getWidth(), maze->getHeight(), options.layout)) return nullptr;
+        if (options.maxWeight > 0) {
+            maze->fillRandomWeights(options.maxWeight, options.seed);
+        }
+        maze->setCellLayout(options.layout);
+        record.add("source", options.input)
+              .add("layout", std::string(CellLayout::name(options.layout)))
+              .add("load_ns", std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        return maze;
+    }
+
+    if (options.width < 1 || options.height < 1) {
+        std::cerr << "Width and height must be positive\n";
+        return nullptr;
+    }
+    if (!checkCellCount(options.width, options.height, options.layout)) return nullptr;
+
+    auto maze = std::make_unique<Maze>(options.width, options.height);
+    maze->setCellLayout(options.layout);
+    int cycles = resolveCycles(options);
+
+    auto start = Clock::now();
+    if (options.seeded) maze->generateMaze(cycles, options.seed);
+    else maze->generateMaze(cycles);
+    if (options.maxWeight > 0) {
+        maze->fillRandomWeights(options.maxWeight, maze->getSeed());
+    }
+    record.add("source", std::string("generated"))
+          .add("layout", std::string(CellLayout::name(options.layout)))
+          .add("seed", maze->getSeed())
+          .add("cycles", cycles)
+          .add("generate_ns", std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    return maze;
+}
+
+bool resolveEndpoints(const Maze& maze, Options& options) {
+    if (options.endX < 0) options.endX = maze.getWidth() - 1;
+    if (options.endY < 0) options.endY = maze.getHeight() - 1;
+
+    auto inside = [&](int x, int y) {
+        return x >= 0 && x < maze.getWidth() && y >= 0 && y < maze.getHeight();
+    };
+    if (!inside(options.startX, options.startY) || !inside(options.endX, options.endY)) {
+        std::cerr << "Start and end must lie inside the maze\n";
+        return false;
+    }
+    return true;
+}
+
+PathResult runSolver(const Maze& maze, const Options& options, Algorithm algorithm) {
+    PathFinder pf(&maze, options.startX, options.startY, options.endX, options.endY);
+    return pf.solve(algorithm);
+}
+
+int commandGenerate(const Options& options) {
+    Record record;
+    std::unique_ptr<Maze> maze = obtainMaze(options, record);
+    if (!maze) return 1;
+
+    record.add("width", maze->getWidth()).add("height", maze->getHeight());
+
+    if (!options.output.empty()) {
+        std::string error;
+        if (!writeMazeFile(*maze, options, &error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        record.add("saved", options.output);
+    }
+    if (!options.replayPath.empty()) {
+        MazeReplay replay = recordReplay(*maze);
+        std::string error;
+        if (!saveReplay(replay, options.replayPath, &error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        record.add("replay", options.replayPath).add("replay_bytes", replay.encodedBytes());
+    }
+
+    record.print(options.format, true);
+    return 0;
+}
+
+int commandSolve(Options options) {
+    Record base;
+    std::unique_ptr<Maze> maze = obtainMaze(options, base);
+    if (!maze || !resolveEndpoints(*maze, options)) return 1;
+
+    std::vector<AlgorithmInfo> algorithms;
+    Algorithm chosen;
+    if (options.algorithm == "all") {
+        algorithms = PathFinder::algorithms();
+    } else if (options.algorithm.empty()) {
+        algorithms = {PathFinder::algorithms().front()};
+    } else if (PathFinder::findAlgorithm(options.algorithm, chosen)) {
+        for (const AlgorithmInfo& info : PathFinder::algorithms()) {
+            if (info.id == chosen) algorithms = {info};
+        }
+    } else {
+        std::cerr << "Unknown algorithm: " << options.algorithm << "\n";
+        return 2;
+    }
+
+    // The replay holds one solve: the first algorithm run
+    std::unique_ptr<MazeReplay> replay;
+    if (!options.replayPath.empty()) {
+        replay = std::make_unique<MazeReplay>(recordReplay(*maze));
+    }
+
+    bool header = true;
+    for (const AlgorithmInfo& info : algorithms) {
+        PathResult result = runSolver(*maze, options, info.id);
+        const SearchStats& stats = result.stats;
+        if (replay && !replay->hasSolve()) {
+            replay->recordSolve(result, info.name, options.startX, options.startY, options.endX, options.endY);
+        }
+
+        Record record;
+        record.add("algorithm", std::string(info.name))
+              .add("width", maze->getWidth())
+              .add("height", maze->getHeight())
+              .add("found", result.found)
+              .add("path_length", result.path.size())
+              .add("total_cost", result.totalCost)
+              .add("explored", result.explored.size())
+              .add("setup_ns", stats.setupNs)
+              .add("search_ns", stats.searchNs)
+              .add("reconstruct_ns", stats.reconstructNs)
+              .add("nodes_expanded", stats.nodesExpanded)
+              .add("peak_frontier", stats.peakFrontier)
+              .add("neighbor_checks", stats.neighborChecks)
+              .add("bytes_allocated", stats.bytesAllocated);
+        record.print(options.format, header);
+        header = false;
+    }
+
+    std::string error;
+    if (replay && !saveReplay(*replay, options.replayPath, &error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+int commandReport(const Options& options) {
+    Record record;
+    std::unique_ptr<Maze> maze = obtainMaze(options, record);
+    if (!maze) return 1;
+
+    auto start = Clock::now();
+    MazeMetrics metrics = analyzeMaze(*maze, options.threads);
+    long long analyzeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    record.add("width", maze->getWidth())
+          .add("height", maze->getHeight())
+          .add("cells", metrics.cells)
+          .add("passages", metrics.passages)
+          .add("dead_ends", metrics.deadEnds)
+          .add("junctions", metrics.junctions)
+          .add("degree_0", metrics.degreeHistogram[0])
+          .add("degree_1", metrics.degreeHistogram[1])
+          .add("degree_2", metrics.degreeHistogram[2])
+          .add("degree_3", metrics.degreeHistogram[3])
+          .add("degree_4", metrics.degreeHistogram[4])
+          .add("longest_corridor", metrics.longestCorridor)
+          .add("components", metrics.components)
+          .add("cycle_rank", metrics.cycles)
+          .add("diameter_estimate", metrics.diameterEstimate)
+          .add("solvable", metrics.solvable)
+          .add("solution_length", metrics.solutionLength)
+          .add("solution_turns", metrics.solutionTurns)
+          .add("analyze_ns", analyzeNs);
+    record.print(options.format, true);
+    return 0;
+}
+
+int commandValidate(const Options& options) {
+    Record record;
+    std::unique_ptr<Maze> maze = obtainMaze(options, record);
+    if (!maze) return 1;
+
+    auto start = Clock::now();
+    MazeValidation report = validateMaze(*maze, options.threads);
+    long long validateNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    record.add("width", maze->getWidth())
+          .add("height", maze->getHeight())
+          .add("cells", report.cells)
+          .add("passages", report.passages)
+          .add("mismatched_walls", report.mismatchedWalls)
+          .add("open_border_walls", report.openBorderWalls)
+          .add("components", report.components)
+          .add("cycle_rank", report.cycleRank)
+          .add("unreachable_cells", report.unreachableCells)
+          .add("unreachable_regions", report.unreachable.size())
+          .add("symmetric", report.symmetric())
+          .add("connected", report.connected())
+          .add("perfect", report.perfect());
+    if (!report.mismatches.empty()) {
+        const WallMismatch& m = report.mismatches.front();
+        record.add("first_mismatch", std::to_string(m.x) + "," + std::to_string(m.y) +
+                                     (m.direction == 1 ? " right" : " bottom"));
+    }
+    if (!report.unreachable.empty()) {
+        const UnreachableRegion& region = report.unreachable.front();
+        record.add("largest_unreachable", std::to_string(region.x) + "," + std::to_string(region.y) +
+                                          " (" + std::to_string(region.cells) + " cells)");
+    }
+    record.add("validate_ns", validateNs);
+    record.print(options.format, true);
+    return report.symmetric() && report.connected() ? 0 : 3;
+}
+
+int commandExport(Options options) {
+    if (options.output.empty()) {
+        std::cerr << "export needs --out FILE.png or FILE.svg\n";
+        return 2;
+    }
+
+    Record record;
+    std::unique_ptr<Maze> maze = obtainMaze(options, record);
+    if (!maze || !resolveEndpoints(*maze, options)) return 1;
+
+    // Only overlay a solution when an algorithm was asked for explicitly
+    PathResult result;
+    bool solved = !options.algorithm.empty();
+    Algorithm algorithm;
+    if (solved && !PathFinder::findAlgorithm(options.algorithm, algorithm)) {
+        std::cerr << "Unknown algorithm: " << options.algorithm << "\n";
+        return 2;
+    }
+    if (solved) result = runSolver(*maze, options, algorithm);
+
+    ExportOptions exportOptions;
+    exportOptions.cellSize = options.cellSize;
+    MazeExporter exporter(maze.get(), solved ? &result : nullptr);
+    if (solved) exporter.setEndpoints(options.startX, options.startY, options.endX, options.endY);
+
+    const std::string& out = options.output;
+    bool svg = out.size() >= 4 && out.compare(out.size() - 4, 4, ".svg") == 0;
+
+    auto start = Clock::now();
+    bool ok = svg ? exporter.exportSvg(out, exportOptions) : exporter.exportPng(out, exportOptions);
+    if (!ok) {
+        std::cerr << "Export failed: " << exporter.lastError() << "\n";
+        return 1;
+    }
+
+    record.add("width", maze->getWidth())
+          .add("height", maze->getHeight())
+          .add("exported", out)
+          .add("export_ns", std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    record.print(options.format, true);
+    return 0;
+}
+
+int commandRace(Options options) {
+    Record base;
+    std::unique_ptr<Maze> maze = obtainMaze(options, base);
+    if (!maze || !resolveEndpoints(*maze, options)) return 1;
+
+    SolverRace race(maze.get(), options.startX, options.startY, options.endX, options.endY);
+    race.start();
+    race.wait();
+
+    for (int i = 0; i < race.laneCount(); i++) {
+        const RaceLane& lane = race.lane(i);
+        Record record;
+        record.add("algorithm", std::string(lane.algorithm.name))
+              .add("cpu", lane.cpu)
+              .add("found", lane.result.found)
+              .add("path_length", lane.result.path.size())
+              .add("total_cost", lane.result.totalCost)
+              .add("nodes_expanded", lane.result.stats.nodesExpanded)
+              .add("wall_ns", lane.wallNs)
+              .add("setup_ns", lane.result.stats.setupNs)
+              .add("search_ns", lane.result.stats.searchNs);
+        record.print(options.format, i == 0);
+    }
+    return 0;
+}
+
+// Reads every shard back and checks each record against a fresh
+// generation of its maze (and solve, when solutions were stored);
+// returns the number of bad records, or -1 if a shard is unreadable
+long long verifyArchive(const std::string& prefix, int shards, const BulkOptions& bulk, long long& records) {
+    long long bad = 0;
+    uint64_t expected = 0;
+    for (int shard = 0; shard < shards; shard++) {
+        std::string error;
+        bool read = readArchiveShard(MazeArchiveWriter::shardName(prefix, shard), [&](ArchiveRecord& record) {
+            Maze fresh(bulk.width, bulk.height);
+            fresh.generateMaze(record.cycles, record.seed, record.index);
+            const Maze& stored = *record.maze;
+            bool same = record.index == expected && record.solved == bulk.solve &&
+                        stored.getWidth() == fresh.getWidth() && stored.getHeight() == fresh.getHeight() &&
+                        std::equal(fresh.wallMasks(), fresh.wallMasks() + static_cast<size_t>(bulk.width) * bulk.height,
+                                   stored.wallMasks());
+            if (same && record.solved) {
+                PathFinder pf(&fresh, 0, 0, bulk.width - 1, bulk.height - 1);
+                PathResult solution = pf.solve(bulk.algorithm);
+                same = record.found == solution.found &&
+                       std::equal(record.path.begin(), record.path.end(),
+                                  solution.path.begin(), solution.path.end());
+            }
+            if (!same) bad++;
+            expected++;
+            records++;
+            return true;
+        }, &error);
+        if (!read) {
+            std::cerr << error << "\n";
+            return -1;
+        }
+    }
+    return bad;
+}
+
+int commandBulk(const Options& options) {
+    if (options.output.empty()) {
+        std::cerr << "bulk needs --out PREFIX (shards are written as PREFIX-NNNNN.mzar)\n";
+        return 2;
+    }
+
+    BulkOptions bulk;
+    bulk.count = options.count;
+    bulk.width = options.width;
+    bulk.height = options.height;
+    bulk.cycles = resolveCycles(options);
+    bulk.seed = options.seeded ? options.seed : std::random_device()();
+    bulk.threads = options.threads;
+    bulk.shardSize = options.shardSize;
+
+    // Solutions are stored only when an algorithm is named
+    bulk.solve = !options.algorithm.empty();
+    if (bulk.solve && !PathFinder::findAlgorithm(options.algorithm, bulk.algorithm)) {
+        std::cerr << "Unknown algorithm: " << options.algorithm << "\n";
+        return 2;
+    }
+
+    BulkGenerator generator(bulk);
+    BulkStats stats;
+    if (!generator.run(options.output, stats)) {
+        std::cerr << "Bulk generation failed: " << generator.lastError() << "\n";
+        return 1;
+    }
+
+    Record record;
+    record.add("mazes_per_sec", stats.mazesPerSecond)
+          .add("mazes", stats.mazes)
+          .add("width", bulk.width)
+          .add("height", bulk.height)
+          .add("cycles", bulk.cycles)
+          .add("seed", bulk.seed)
+          .add("solved", bulk.solve)
+          .add("threads", stats.threads)
+          .add("shards", stats.shards)
+          .add("bytes", stats.bytes)
+          .add("elapsed_ns", stats.elapsedNs)
+          .add("generate_ns", stats.generateNs)
+          .add("solve_ns", stats.solveNs)
+          .add("encode_ns", stats.encodeNs);
+
+    if (options.verify) {
+        long long records = 0;
+        auto start = Clock::now();
+        long long bad = verifyArchive(options.output, stats.shards, bulk, records);
+        if (bad < 0) return 1;
+        record.add("verified", records)
+              .add("mismatched", bad)
+              .add("verify_ns", std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        record.print(options.format, true);
+        return bad == 0 && records == stats.mazes ? 0 : 1;
+    }
+    record.print(options.format, true);
+    return 0;
+}
+
+int commandReplay(const Options& options) {
+    if (options.input.empty()) {
+        std::cerr << "replay needs --in FILE\n";
+        return 2;
+    }
+
+    std::string error;
+    auto start = Clock::now();
+    std::unique_ptr<MazeReplay> replay = loadReplay(options.input, &error);
+    if (!replay) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    long long loadNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    Record record;
+    record.add("source", options.input)
+          .add("width", replay->width)
+          .add("height", replay->height)
+          .add("seed", replay->seed)
+          .add("algorithm", replay->algorithm)
+          .add("found", replay->found)
+          .add("wall_steps", replay->walls.size())
+          .add("explored_steps", replay->explored.size())
+          .add("path_steps", replay->path.size())
+          .add("bytes", replay->encodedBytes())
+          .add("raw_bytes", replay->rawBytes())
+          .add("load_ns", loadNs);
+
+    if (!options.output.empty()) {
+        std::unique_ptr<Maze> maze = replay->buildMaze();
+        if (!writeMazeFile(*maze, options, &error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        record.add("saved", options.output);
+    }
+
+    record.print(options.format, true);
+    return 0;
+}
+
+// One op per line; blank lines and lines starting with # are skipped
+bool readEditScript(const std::string& filename, std::vector<ConnectivityOp>& ops) {
+    std::ifstream in(filename);
+    if (!in) {
+        std::cerr << "Cannot open " << filename << "\n";
+        return false;
+    }
+    std::string line;
+    for (int number = 1; std::getline(in, line); number++) {
+        std::istringstream fields(line);
+        std::string verb;
+        if (!(fields >> verb) || verb[0] == '#') continue;
+
+        ConnectivityOp op;
+        bool ok;
+        if (verb == "query") {
+            op.kind = ConnectivityOp::Kind::Query;
+            ok = static_cast<bool>(fields >> op.x >> op.y >> op.x2 >> op.y2);
+        } else {
+            if (verb == "open") op.kind = ConnectivityOp::Kind::Open;
+            else if (verb == "close") op.kind = ConnectivityOp::Kind::Close;
+            else if (verb == "toggle") op.kind = ConnectivityOp::Kind::Toggle;
+            else verb.clear();
+            ok = !verb.empty() && static_cast<bool>(fields >> op.x >> op.y >> op.direction) &&
+                 op.direction >= 0 && op.direction <= 3;
+        }
+        if (!ok) {
+            std::cerr << filename << ":" << number << ": malformed line: " << line << "\n";
+            return false;
+        }
+        ops.push_back(op);
+    }
+    return true;
+}
+
+int commandEdit(const Options& options) {
+    if (options.scriptPath.empty()) {
+        std::cerr << "edit needs --script FILE\n";
+        return 2;
+    }
+    std::vector<ConnectivityOp> ops;
+    if (!readEditScript(options.scriptPath, ops)) return 2;
+
+    Record record;
+    std::unique_ptr<Maze> maze = obtainMaze(options, record);
+    if (!maze) return 1;
+
+    // Offline: the whole script at once, maze untouched
+    auto start = Clock::now();
+    std::vector<bool> offline = solveConnectivityOffline(*maze, ops);
+    long long offlineNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    // Semi-online: apply each edit to the maze, then answer from the mirror
+    start = Clock::now();
+    DynamicConnectivity live(maze.get());
+    long long setupNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    std::string answers;
+    long long edits = 0, reachable = 0;
+    start = Clock::now();
+    for (const ConnectivityOp& op : ops) {
+        if (op.kind == ConnectivityOp::Kind::Query) {
+            bool connected = live.connected(op.x, op.y, op.x2, op.y2);
+            answers += connected ? '1' : '0';
+            reachable += connected;
+            continue;
+        }
+        // Border walls stay closed, as in the offline pass
+        static const int dx[4] = {0, 1, 0, -1};
+        static const int dy[4] = {-1, 0, 1, 0};
+        int nx = op.x + dx[op.direction], ny = op.y + dy[op.direction];
+        if (op.x < 0 || op.x >= maze->getWidth() || op.y < 0 || op.y >= maze->getHeight() ||
+            nx < 0 || nx >= maze->getWidth() || ny < 0 || ny >= maze->getHeight()) {
+            continue;
+        }
+        if (op.kind == ConnectivityOp::Kind::Toggle) maze->toggleWall(op.x, op.y, op.direction);
+        else maze->setWall(op.x, op.y, op.direction, op.kind == ConnectivityOp::Kind::Close);
+        live.wallChanged(op.x, op.y, op.direction);
+        edits++;
+    }
+    long long onlineNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    bool agree = offline.size() == answers.size();
+    for (size_t i = 0; agree && i < offline.size(); i++) agree = offline[i] == (answers[i] == '1');
+
+    record.add("width", maze->getWidth())
+          .add("height", maze->getHeight())
+          .add("ops", ops.size())
+          .add("edits", edits)
+          .add("queries", answers.size())
+          .add("connected", reachable)
+          .add("answers", answers)
+          .add("components", live.components())
+          .add("offline_ns", offlineNs)
+          .add("online_setup_ns", setupNs)
+          .add("online_ns", onlineNs)
+          .add("online_rebuilds", live.rebuildCount())
+          .add("agree", agree);
+
+    if (!options.output.empty()) {
+        std::string error;
+        if (!writeMazeFile(*maze, options, &error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        record.add("saved", options.output);
+    }
+    record.print(options.format, true);
+    return agree ? 0 : 1;
+}
+
+void printMemory(const std::string& format) {
+    bool header = true;
+    for (const SubsystemMemory& m : MemoryTracker::snapshot()) {
+        Record record;
+        record.add("subsystem", std::string(m.name))
+              .add("current_bytes", m.currentBytes)
+              .add("peak_bytes", m.peakBytes)
+              .add("allocations", m.allocations);
+        record.print(format, header);
+        header = false;
+    }
+
+    Record process;
+    process.add("subsystem", std::string("process"))
+           .add("current_bytes", MemoryTracker::currentRssBytes())
+           .add("peak_bytes", MemoryTracker::peakRssBytes())
+           .add("allocations", -1);
+    process.print(format, false);
+}
+
+int runCommand(const Options& options) {
+    if (options.command == "generate") return commandGenerate(options);
+    if (options.command == "solve") return commandSolve(options);
+    if (options.command == "report") return commandReport(options);
+    if (options.command == "validate") return commandValidate(options);
+    if (options.command == "export") return commandExport(options);
+    if (options.command == "race") return commandRace(options);
+    if (options.command == "bulk") return commandBulk(options);
+    if (options.command == "replay") return commandReplay(options);
+    if (options.command == "edit") return commandEdit(options);
+
+    std::cerr << "Unknown command: " << options.command << "\n";
+    printUsage();
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    if (!options.tracePath.empty()) {
+        Tracer::setEnabled(true);
+    }
+
+    // A maze too large for memory fails like any other command error
+    int status;
+    try {
+        status = runCommand(options);
+    } catch (const std::bad_alloc&) {
+        std::cerr << "Out of memory\n";
+        status = 1;
+    }
+
+    std::string traceError;
+    if (!options.tracePath.empty() && !Tracer::writeChromeJson(options.tracePath, &traceError)) {
+        std::cerr << traceError << "\n";
+        if (status == 0) status = 1;
+    }
+    if (status == 0 && options.memory) {
+        printMemory(options.format);
+    }
+    return status;
+}
@@ -0,0 +1,238 @@
+#include "mazeconnectivity.h"
+#include "tracer.h"
+#include <algorithm>
+
+namespace {
+
+// Wall slot of the passage on this side of (x, y), or -1 on the border
+int wallSlot(int width, int height, int x, int y, int direction) {
+    if (x < 0 || x >= width || y < 0 || y >= height) return -1;
+    switch (direction) {
+        case 0: return y > 0 ? ((y - 1) * width + x) * 2 + 1 : -1;
+        case 1: return x + 1 < width ? (y * width + x) * 2 : -1;
+        case 2: return y + 1 < height ? (y * width + x) * 2 + 1 : -1;
+        case 3: return x > 0 ? (y * width + x - 1) * 2 : -1;
+        default: return -1;
+    }
+}
+
+// The two cells a slot separates
+int slotNeighbour(int width, int slot) {
+    return slot / 2 + ((slot & 1) ? width : 1);
+}
+
+bool passageOpen(const uint8_t* masks, int width, int slot) {
+    int cell = slot / 2;
+    if (slot & 1) return !(masks[cell] & WallBottom) && !(masks[cell + width] & WallTop);
+    return !(masks[cell] & WallRight) && !(masks[cell + 1] & WallLeft);
+}
+
+bool inside(int width, int height, int x, int y) {
+    return x >= 0 && x < width && y >= 0 && y < height;
+}
+
+// Depth-first walk of the segment tree: node n covers ops [lo, hi) and
+// holds the slots open over all of it in spans[start[n] .. start[n + 1])
+struct OfflineWalk {
+    const std::vector<ConnectivityOp>& ops;
+    int width, height;
+    const std::vector<int>& start;
+    const std::vector<int>& spans;
+    RollbackUnionFind& uf;
+    std::vector<bool>& answers;
+
+    void walk(int node, int lo, int hi) {
+        size_t snapshot = uf.snapshot();
+        for (int i = start[node]; i < start[node + 1]; i++) {
+            uf.unite(spans[i] / 2, slotNeighbour(width, spans[i]));
+        }
+        if (hi - lo == 1) {
+            const ConnectivityOp& op = ops[lo];
+            if (op.kind == ConnectivityOp::Kind::Query) {
+                answers.push_back(inside(width, height, op.x, op.y) && inside(width, height, op.x2, op.y2) &&
+                                  uf.connected(op.y * width + op.x, op.y2 * width + op.x2));
+            }
+        } else {
+            int mid = lo + (hi - lo) / 2;
+            walk(node * 2, lo, mid);
+            if (mid < static_cast<int>(ops.size())) walk(node * 2 + 1, mid, hi);
+        }
+        uf.rollback(snapshot);
+    }
+};
+
+} // namespace
+
+std::vector<bool> solveConnectivityOffline(const Maze& maze, const std::vector<ConnectivityOp>& ops) {
+    TRACE_SCOPE("connectivity", "offline");
+    std::vector<bool> answers;
+    int width = maze.getWidth(), height = maze.getHeight();
+    int opCount = static_cast<int>(ops.size());
+    if (opCount == 0 || width <= 0 || height <= 0) {
+        for (const ConnectivityOp& op : ops) {
+            if (op.kind == ConnectivityOp::Kind::Query) answers.push_back(false);
+        }
+        return answers;
+    }
+
+    int size = 1;
+    while (size < opCount) size <<= 1;
+
+    // (tree node, slot) for every span a passage stays open, split over the
+    // O(log ops) nodes that cover it
+    std::vector<std::pair<int, int>> pieces;
+    auto addSpan = [&](int slot, int from, int to) {
+        for (int l = from + size, r = to + size; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) pieces.push_back({l++, slot});
+            if (r & 1) pieces.push_back({--r, slot});
+        }
+    };
+
+    const uint8_t* masks = maze.wallMasks();
+    std::vector<int> openSince(static_cast<size_t>(width) * height * 2, -1);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int slot = (y * width + x) * 2;
+            if (x + 1 < width && passageOpen(masks, width, slot)) openSince[slot] = 0;
+            if (y + 1 < height && passageOpen(masks, width, slot + 1)) openSince[slot + 1] = 0;
+        }
+    }
+
+    for (int i = 0; i < opCount; i++) {
+        const ConnectivityOp& op = ops[i];
+        if (op.kind == ConnectivityOp::Kind::Query) continue;
+        int slot = wallSlot(width, height, op.x, op.y, op.direction);
+        if (slot < 0) continue;
+        bool open = openSince[slot] >= 0;
+        bool wantOpen = op.kind == ConnectivityOp::Kind::Open ||
+                        (op.kind == ConnectivityOp::Kind::Toggle && !open);
+        if (wantOpen == open) continue;
+        if (wantOpen) {
+            openSince[slot] = i;
+        } else {
+            addSpan(slot, openSince[slot], i);
+            openSince[slot] = -1;
+        }
+    }
+    for (size_t slot = 0; slot < openSince.size(); slot++) {
+        if (openSince[slot] >= 0) addSpan(static_cast<int>(slot), openSince[slot], opCount);
+    }
+
+    // Bucket the pieces by node
+    std::vector<int> start(size * 2 + 1, 0);
+    for (const auto& piece : pieces) start[piece.first + 1]++;
+    for (size_t n = 1; n < start.size(); n++) start[n] += start[n - 1];
+    std::vector<int> spans(pieces.size());
+    {
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (const auto& piece : pieces) spans[fill[piece.first]++] = piece.second;
+    }
+    pieces.clear();
+    pieces.shrink_to_fit();
+
+    RollbackUnionFind uf(width * height);
+    OfflineWalk walker{ops, width, height, start, spans, uf, answers};
+    walker.walk(1, 0, size);
+    return answers;
+}
+
+DynamicConnectivity::DynamicConnectivity(const Maze* maze, int radius)
+    : maze(maze), width(maze->getWidth()), height(maze->getHeight()),
+      radius(std::max(1, radius)), uf(maze->getWidth() * maze->getHeight()),
+      baseSnapshot(0), hotCells(static_cast<size_t>(maze->getWidth()) * maze->getHeight(), 0),
+      windows(0), rebuilds(0) {
+    refresh();
+}
+
+bool DynamicConnectivity::slotOpen(int slot) const {
+    return passageOpen(maze->wallMasks(), width, slot);
+}
+
+void DynamicConnectivity::refresh() {
+    TRACE_SCOPE("connectivity", "refresh");
+    std::fill(hotCells.begin(), hotCells.end(), 0);
+    windows = 0;
+    hotSlots.clear();
+    buildBase();
+}
+
+void DynamicConnectivity::rebuild(int x, int y) {
+    TRACE_SCOPE("connectivity", "rebuild");
+    if (windows == MaxWindows) {
+        std::fill(hotCells.begin(), hotCells.end(), 0);
+        windows = 0;
+    }
+    windows++;
+    for (int cy = std::max(0, y - radius); cy <= std::min(height - 1, y + radius); cy++) {
+        for (int cx = std::max(0, x - radius); cx <= std::min(width - 1, x + radius); cx++) {
+            hotCells[cy * width + cx] = 1;
+        }
+    }
+
+    hotSlots.clear();
+    for (int cell = 0; cell < width * height; cell++) {
+        if (!hotCells[cell]) continue;
+        if (cell % width + 1 < width) hotSlots.push_back(cell * 2);
+        if (cell / width + 1 < height) hotSlots.push_back(cell * 2 + 1);
+    }
+    buildBase();
+}
+
+// Labels the components of the open cold passages with a path-halving
+// union-find rooted at the smallest index, then loads them into uf as
+// depth-one trees: one cheap unite per cell, and finds stay short
+void DynamicConnectivity::buildBase() {
+    int cells = width * height;
+    labels.resize(cells);
+    for (int cell = 0; cell < cells; cell++) labels[cell] = cell;
+    auto root = [&](int cell) {
+        while (labels[cell] != cell) {
+            labels[cell] = labels[labels[cell]];
+            cell = labels[cell];
+        }
+        return cell;
+    };
+    auto link = [&](int a, int b) {
+        a = root(a);
+        b = root(b);
+        if (a < b) labels[b] = a;
+        else if (b < a) labels[a] = b;
+    };
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int cell = y * width + x;
+            if (hotCells[cell]) continue;
+            if (x + 1 < width && slotOpen(cell * 2)) link(cell, cell + 1);
+            if (y + 1 < height && slotOpen(cell * 2 + 1)) link(cell, cell + width);
+        }
+    }
+
+    uf.reset();
+    for (int cell = 0; cell < cells; cell++) {
+        int r = root(cell);
+        labels[cell] = r;
+        if (r != cell) uf.unite(r, cell);
+    }
+    baseSnapshot = uf.snapshot();
+    rebuilds++;
+}
+
+void DynamicConnectivity::overlay() {
+    uf.rollback(baseSnapshot);
+    for (int slot : hotSlots) {
+        if (slotOpen(slot)) uf.unite(slot / 2, slotNeighbour(width, slot));
+    }
+}
+
+void DynamicConnectivity::wallChanged(int x, int y, int direction) {
+    int slot = wallSlot(width, height, x, y, direction);
+    if (slot < 0) return;
+    int owner = slot / 2;
+    if (!hotCells[owner]) rebuild(owner % width, owner / width);
+    overlay();
+}
+
+bool DynamicConnectivity::connected(int ax, int ay, int bx, int by) const {
+    if (!inside(width, height, ax, ay) || !inside(width, height, bx, by)) return false;
+    return uf.connected(ay * width + ax, by * width + bx);
+}
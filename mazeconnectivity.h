@@ -0,0 +1,71 @@
+#ifndef MAZECONNECTIVITY_H
+#define MAZECONNECTIVITY_H
+
+#include <cstdint>
+#include <vector>
+#include "maze.h"
+#include "unionfind.h"
+
+// Connectivity of a maze whose walls are being edited. Two neighbouring
+// cells are joined when the wall between them is open on both sides (as
+// in validateMaze).
+
+// One step of an edit script: change the wall on one side of (x, y), or ask
+// whether (x, y) and (x2, y2) are connected at this point in the script
+struct ConnectivityOp {
+    enum class Kind { Open, Close, Toggle, Query };
+    Kind kind = Kind::Query;
+    int x = 0, y = 0;
+    int direction = 0;      // edits, numbered as in Maze::hasWall
+    int x2 = 0, y2 = 0;     // queries
+};
+
+// Offline: answers every query of a whole script, in order, without
+// touching the maze. Each passage is open over a set of time intervals;
+// the intervals go into a segment tree over the script, and a depth-first
+// walk unites a node's passages on the way down and rolls them back on the
+// way up. O((cells + ops) log ops log cells).
+std::vector<bool> solveConnectivityOffline(const Maze& maze, const std::vector<ConnectivityOp>& ops);
+
+// Semi-online: mirrors a Maze as it is edited and answers queries at once.
+// Passages near recent edits are "hot" and stay out of the base union-find;
+// every edit rolls back to the base and re-unites the open hot passages,
+// O(hot log cells). An edit outside the hot area adds the square of the
+// given radius around it (starting over once the area holds MaxWindows
+// squares) and rebuilds the base, O(cells log cells), so edits that stay
+// local (a user clicking around one spot) rarely pay for the whole maze.
+class DynamicConnectivity {
+private:
+    const Maze* maze;
+    int width, height;
+    int radius;
+    RollbackUnionFind uf;
+    size_t baseSnapshot;
+    std::vector<uint8_t> hotCells;  // 1 where the cell's right and lower walls are hot
+    std::vector<int> hotSlots;      // wall slots (cell * 2, +1 for the wall below)
+    int windows;                    // squares added since the hot area was last cleared
+    long long rebuilds;
+    std::vector<int> labels;        // scratch for buildBase
+
+    bool slotOpen(int slot) const;
+    void rebuild(int x, int y);
+    void buildBase();
+    void overlay();
+
+public:
+    static constexpr int MaxWindows = 4;
+
+    explicit DynamicConnectivity(const Maze* maze, int radius = 8);
+
+    // Call after the wall on this side of (x, y) changed in the maze
+    void wallChanged(int x, int y, int direction);
+    // Re-read every wall, e.g. after regeneration
+    void refresh();
+
+    bool connected(int ax, int ay, int bx, int by) const;
+    int components() const { return uf.components(); }
+    long long rebuildCount() const { return rebuilds; }
+    size_t hotWalls() const { return hotSlots.size(); }
+};
+
+#endif // MAZECONNECTIVITY_H
@@ -0,0 +1,347 @@
+#include "mazeexporter.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <tuple>
+#include <zlib.h>
+
+namespace {
+
+// Palette indices shared by the PNG and SVG writers
+enum : unsigned char {
+    ColorFloor = 0,
+    ColorWall = 1,
+    ColorExplored = 2,
+    ColorPath = 3,
+    ColorStart = 4,
+    ColorEnd = 5,
+    ColorCount = 6
+};
+
+const unsigned char palette[ColorCount][3] = {
+    {255, 255, 255},  // floor
+    {0, 0, 0},        // wall
+    {255, 200, 0},    // explored (yellow)
+    {0, 255, 0},      // path (green)
+    {0, 0, 255},      // start (blue)
+    {255, 0, 0}       // end (red)
+};
+
+const char* svgColors[ColorCount] = {
+    "#ffffff", "#000000", "#ffc800", "#00ff00", "#0000ff", "#ff0000"
+};
+
+// Minimal streaming PNG encoder: scanlines go straight into deflate and
+// come out as IDAT chunks, so only one output buffer is ever held.
+class PngStream {
+private:
+    std::ofstream out;
+    z_stream zs;
+    std::vector<unsigned char> buffer;
+    bool deflating = false;
+
+    void writeChunk(const char* type, const unsigned char* data, uInt length) {
+        unsigned char header[8] = {
+            static_cast<unsigned char>(length >> 24), static_cast<unsigned char>(length >> 16),
+            static_cast<unsigned char>(length >> 8), static_cast<unsigned char>(length),
+            static_cast<unsigned char>(type[0]), static_cast<unsigned char>(type[1]),
+            static_cast<unsigned char>(type[2]), static_cast<unsigned char>(type[3])
+        };
+        uLong crc = crc32(0L, header + 4, 4);
+        if (length > 0) crc = crc32(crc, data, length);
+        unsigned char footer[4] = {
+            static_cast<unsigned char>(crc >> 24), static_cast<unsigned char>(crc >> 16),
+            static_cast<unsigned char>(crc >> 8), static_cast<unsigned char>(crc)
+        };
+        out.write(reinterpret_cast<const char*>(header), 8);
+        out.write(reinterpret_cast<const char*>(data), length);
+        out.write(reinterpret_cast<const char*>(footer), 4);
+    }
+
+    void pump(int flush) {
+        do {
+            if (zs.avail_out == 0) {
+                writeChunk("IDAT", buffer.data(), static_cast<uInt>(buffer.size()));
+                zs.next_out = buffer.data();
+                zs.avail_out = static_cast<uInt>(buffer.size());
+            }
+            deflate(&zs, flush);
+        } while (zs.avail_in > 0 || zs.avail_out == 0);
+    }
+
+public:
+    PngStream() : buffer(1 << 16) { zs = z_stream(); }
+
+    ~PngStream() {
+        if (deflating) deflateEnd(&zs);
+    }
+
+    bool open(const std::string& filename, uint32_t width, uint32_t height, int level) {
+        out.open(filename, std::ios::binary);
+        if (!out) return false;
+
+        static const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+        out.write(reinterpret_cast<const char*>(signature), 8);
+
+        unsigned char ihdr[13] = {
+            static_cast<unsigned char>(width >> 24), static_cast<unsigned char>(width >> 16),
+            static_cast<unsigned char>(width >> 8), static_cast<unsigned char>(width),
+            static_cast<unsigned char>(height >> 24), static_cast<unsigned char>(height >> 16),
+            static_cast<unsigned char>(height >> 8), static_cast<unsigned char>(height),
+            8,  // bit depth
+            3,  // color type: indexed
+            0, 0, 0
+        };
+        writeChunk("IHDR", ihdr, sizeof(ihdr));
+        writeChunk("PLTE", &palette[0][0], sizeof(palette));
+
+        if (deflateInit(&zs, level) != Z_OK) return false;
+        deflating = true;
+        zs.next_out = buffer.data();
+        zs.avail_out = static_cast<uInt>(buffer.size());
+        return static_cast<bool>(out);
+    }
+
+    // Scanline must start with its filter byte
+    void writeRow(const std::vector<unsigned char>& row) {
+        zs.next_in = const_cast<unsigned char*>(row.data());
+        zs.avail_in = static_cast<uInt>(row.size());
+        pump(Z_NO_FLUSH);
+    }
+
+    bool finish() {
+        zs.next_in = nullptr;
+        zs.avail_in = 0;
+        int status;
+        do {
+            if (zs.avail_out == 0) {
+                writeChunk("IDAT", buffer.data(), static_cast<uInt>(buffer.size()));
+                zs.next_out = buffer.data();
+                zs.avail_out = static_cast<uInt>(buffer.size());
+            }
+            status = deflate(&zs, Z_FINISH);
+        } while (status == Z_OK || zs.avail_out == 0);
+
+        uInt pending = static_cast<uInt>(buffer.size()) - zs.avail_out;
+        if (pending > 0) writeChunk("IDAT", buffer.data(), pending);
+        writeChunk("IEND", nullptr, 0);
+
+        deflateEnd(&zs);
+        deflating = false;
+        out.flush();
+        return status == Z_STREAM_END && static_cast<bool>(out);
+    }
+};
+
+} // namespace
+
+MazeExporter::MazeExporter(const Maze* m, const PathResult* r)
+    : maze(m), result(r) {}
+
+void MazeExporter::setEndpoints(int sx, int sy, int ex, int ey) {
+    startX = sx;
+    startY = sy;
+    endX = ex;
+    endY = ey;
+}
+
+bool MazeExporter::hasOverlay() const {
+    return result || startX >= 0;
+}
+
+// Counting sort by row: memory follows the number of overlaid cells, never
+// the maze area
+MazeExporter::OverlayRows MazeExporter::bucketByRow(const std::pmr::vector<std::pair<int, int>>& cells) const {
+    OverlayRows rows;
+    int h = maze->getHeight();
+    rows.rowStart.assign(static_cast<size_t>(h) + 1, 0);
+    for (const auto& cell : cells) rows.rowStart[cell.second + 1]++;
+    for (int y = 0; y < h; y++) rows.rowStart[y + 1] += rows.rowStart[y];
+    rows.xs.resize(cells.size());
+    std::vector<size_t> fill(rows.rowStart.begin(), rows.rowStart.end() - 1);
+    for (const auto& cell : cells) rows.xs[fill[cell.second]++] = cell.first;
+    return rows;
+}
+
+void MazeExporter::paintRow(int y, const OverlayRows& explored, const OverlayRows& path,
+                            std::vector<unsigned char>& colors) const {
+    std::fill(colors.begin(), colors.end(), ColorFloor);
+    auto paint = [&](const OverlayRows& rows, unsigned char color) {
+        if (rows.rowStart.empty()) return;
+        for (size_t i = rows.rowStart[y]; i < rows.rowStart[y + 1]; i++) colors[rows.xs[i]] = color;
+    };
+    paint(explored, ColorExplored);
+    paint(path, ColorPath);
+
+    int sx = startX, sy = startY, ex = endX, ey = endY;
+    if (sx < 0 && result && !result->path.empty()) {
+        std::tie(sx, sy) = result->path.front();
+        std::tie(ex, ey) = result->path.back();
+    }
+    if (sy == y && sx >= 0) colors[sx] = ColorStart;
+    if (ey == y && ex >= 0) colors[ex] = ColorEnd;
+}
+
+bool MazeExporter::exportPng(const std::string& filename, const ExportOptions& options) {
+    int w = maze->getWidth();
+    int h = maze->getHeight();
+    int cs = options.cellSize;
+    if (cs < 2) {
+        error = "cell size must be at least 2 pixels";
+        return false;
+    }
+
+    // Each cell owns its top wall row and left wall column; one extra
+    // row/column closes the right and bottom borders
+    uint64_t imageWidth = static_cast<uint64_t>(w) * cs + 1;
+    uint64_t imageHeight = static_cast<uint64_t>(h) * cs + 1;
+    if (imageWidth > 0x7fffffff || imageHeight > 0x7fffffff) {
+        error = "image too large for PNG";
+        return false;
+    }
+
+    PngStream png;
+    if (!png.open(filename, static_cast<uint32_t>(imageWidth), static_cast<uint32_t>(imageHeight),
+                  options.compressionLevel)) {
+        error = "cannot open " + filename;
+        return false;
+    }
+
+    OverlayRows explored, path;
+    if (result && options.showExplored) explored = bucketByRow(result->explored);
+    if (result && options.showPath) path = bucketByRow(result->path);
+    std::vector<unsigned char> colors(w, ColorFloor);
+    bool overlay = hasOverlay();
+
+    // Scanline buffers carry the PNG filter byte (0 = none) up front
+    std::vector<unsigned char> wallRow(imageWidth + 1);
+    std::vector<unsigned char> cellRow(imageWidth + 1);
+
+    for (int y = 0; y <= h; y++) {
+        // Wall scanline between row y-1 and row y; lattice corners are solid
+        wallRow[0] = 0;
+        for (int x = 0; x < w; x++) {
+            bool wall = y < h ? maze->hasWall(x, y, 0) : maze->hasWall(x, y - 1, 2);
+            unsigned char color = wall ? ColorWall : ColorFloor;
+            size_t px = static_cast<size_t>(x) * cs + 1;
+            wallRow[px] = ColorWall;
+            std::fill(wallRow.begin() + px + 1, wallRow.begin() + px + cs, color);
+        }
+        wallRow[imageWidth] = ColorWall;
+        png.writeRow(wallRow);
+
+        if (y == h) break;
+
+        // Interior scanline of row y, repeated for the height of the strip
+        cellRow[0] = 0;
+        if (overlay) paintRow(y, explored, path, colors);
+        for (int x = 0; x < w; x++) {
+            size_t px = static_cast<size_t>(x) * cs + 1;
+            unsigned char fill = colors[x];
+            cellRow[px] = maze->hasWall(x, y, 3) ? static_cast<unsigned char>(ColorWall) : fill;
+            std::fill(cellRow.begin() + px + 1, cellRow.begin() + px + cs, fill);
+        }
+        cellRow[imageWidth] = maze->hasWall(w - 1, y, 1) ? ColorWall : ColorFloor;
+        for (int i = 1; i < cs; i++) {
+            png.writeRow(cellRow);
+        }
+    }
+
+    if (!png.finish()) {
+        error = "failed writing " + filename;
+        return false;
+    }
+    return true;
+}
+
+bool MazeExporter::exportSvg(const std::string& filename, const ExportOptions& options) {
+    std::ofstream out(filename);
+    if (!out) {
+        error = "cannot open " + filename;
+        return false;
+    }
+
+    int w = maze->getWidth();
+    int h = maze->getHeight();
+    int cs = options.cellSize;
+
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << w * cs << "\" height=\"" << h * cs
+        << "\" viewBox=\"0 0 " << w << ' ' << h << "\" shape-rendering=\"crispEdges\">\n"
+        << "<rect width=\"" << w << "\" height=\"" << h << "\" fill=\"" << svgColors[ColorFloor] << "\"/>\n";
+
+    // Overlay: horizontal runs of equal color become one rect each
+    if (hasOverlay()) {
+        OverlayRows explored, path;
+        if (result && options.showExplored) explored = bucketByRow(result->explored);
+        if (result && options.showPath) path = bucketByRow(result->path);
+        std::vector<unsigned char> row(w);
+        for (int y = 0; y < h; y++) {
+            paintRow(y, explored, path, row);
+            int x = 0;
+            while (x < w) {
+                int start = x;
+                unsigned char color = row[x];
+                while (x < w && row[x] == color) x++;
+                if (color != ColorFloor) {
+                    out << "<rect x=\"" << start << "\" y=\"" << y << "\" width=\"" << x - start
+                        << "\" height=\"1\" fill=\"" << svgColors[color] << "\"/>\n";
+                }
+            }
+        }
+    }
+
+    // Walls: collinear segments merged into single runs, a bounded number
+    // of runs per <path> element to keep each attribute a sane length
+    const int runsPerPath = 1024;
+    int runsInPath = 0;
+    auto emitRun = [&](char axis, int x, int y, int length) {
+        if (runsInPath == 0) {
+            out << "<path fill=\"none\" stroke=\"" << svgColors[ColorWall]
+                << "\" stroke-width=\"0.1\" stroke-linecap=\"square\" d=\"";
+        }
+        out << 'M' << x << ' ' << y << axis << (axis == 'H' ? x + length : y + length);
+        if (++runsInPath == runsPerPath) {
+            out << "\"/>\n";
+            runsInPath = 0;
+        }
+    };
+
+    // Horizontal runs along each grid line y = 0..h
+    for (int y = 0; y <= h; y++) {
+        int runStart = -1;
+        for (int x = 0; x <= w; x++) {
+            bool wall = x < w && (y < h ? maze->hasWall(x, y, 0) : maze->hasWall(x, y - 1, 2));
+            if (wall && runStart < 0) {
+                runStart = x;
+            } else if (!wall && runStart >= 0) {
+                emitRun('H', runStart, y, x - runStart);
+                runStart = -1;
+            }
+        }
+    }
+
+    // Vertical runs, tracked per column while scanning rows in order
+    std::vector<int> columnRun(w + 1, -1);
+    for (int y = 0; y <= h; y++) {
+        for (int x = 0; x <= w; x++) {
+            bool wall = y < h && (x < w ? maze->hasWall(x, y, 3) : maze->hasWall(x - 1, y, 1));
+            if (wall && columnRun[x] < 0) {
+                columnRun[x] = y;
+            } else if (!wall && columnRun[x] >= 0) {
+                emitRun('V', x, columnRun[x], y - columnRun[x]);
+                columnRun[x] = -1;
+            }
+        }
+    }
+    if (runsInPath > 0) out << "\"/>\n";
+
+    out << "</svg>\n";
+    out.flush();
+    if (!out) {
+        error = "failed writing " + filename;
+        return false;
+    }
+    return true;
+}
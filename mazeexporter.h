@@ -0,0 +1,56 @@
+#ifndef MAZEEXPORTER_H
+#define MAZEEXPORTER_H
+
+#include <string>
+#include <vector>
+#include "maze.h"
+#include "pathfinder.h"
+
+struct ExportOptions {
+    int cellSize = 4;           // pixels per cell (PNG) or user units (SVG)
+    bool showExplored = true;   // overlay PathResult::explored
+    bool showPath = true;       // overlay PathResult::path
+    int compressionLevel = 1;   // zlib level for PNG, 1 = fastest
+};
+
+// Offscreen renderer for a maze and optional solution overlay.
+// Needs no display or GUI toolkit, so it runs fine in batch jobs.
+class MazeExporter {
+private:
+    // Overlaid cells bucketed by row: the x of every cell of row y with
+    // the given color is in xs[rowStart[y] .. rowStart[y + 1])
+    struct OverlayRows {
+        std::vector<size_t> rowStart;
+        std::vector<int> xs;
+    };
+
+    const Maze* maze;
+    const PathResult* result;
+    int startX = -1, startY = -1, endX = -1, endY = -1;
+    std::string error;
+
+    OverlayRows bucketByRow(const std::pmr::vector<std::pair<int, int>>& cells) const;
+    bool hasOverlay() const;
+    // Overlay colors of row y into colors (one entry per cell)
+    void paintRow(int y, const OverlayRows& explored, const OverlayRows& path,
+                  std::vector<unsigned char>& colors) const;
+
+public:
+    MazeExporter(const Maze* m, const PathResult* r = nullptr);
+
+    // Cells drawn as start and end markers; without this the ends of the
+    // path are used, so nothing is marked when no path was found
+    void setEndpoints(int sx, int sy, int ex, int ey);
+
+    // Indexed-color PNG, compressed one cell row (strip) at a time so memory
+    // stays bounded by the image width rather than its area (plus the
+    // overlaid cells, bucketed by row)
+    bool exportPng(const std::string& filename, const ExportOptions& options = ExportOptions());
+
+    // SVG with collinear wall segments merged into long runs
+    bool exportSvg(const std::string& filename, const ExportOptions& options = ExportOptions());
+
+    const std::string& lastError() const { return error; }
+};
+
+#endif // MAZEEXPORTER_H
@@ -0,0 +1,137 @@
+#include "mazeio.h"
+#include "mazeutil.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+const char magic[4] = {'M', 'A', 'Z', 'E'};
+const uint32_t formatVersion = 1;
+
+void writeU32(std::ostream& out, uint32_t value) {
+    unsigned char bytes[4] = {
+        static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8),
+        static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24)
+    };
+    out.write(reinterpret_cast<const char*>(bytes), 4);
+}
+
+bool readU32(std::istream& in, uint32_t& value) {
+    unsigned char bytes[4];
+    if (!in.read(reinterpret_cast<char*>(bytes), 4)) return false;
+    value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    return true;
+}
+
+} // namespace
+
+unsigned char packCell(const Cell& cell) {
+    return (cell.top ? 1 : 0) | (cell.right ? 2 : 0) | (cell.bottom ? 4 : 0) | (cell.left ? 8 : 0);
+}
+
+Cell unpackCell(unsigned char bits) {
+    Cell cell;
+    cell.top = bits & 1;
+    cell.right = bits & 2;
+    cell.bottom = bits & 4;
+    cell.left = bits & 8;
+    return cell;
+}
+
+void packWallMasks(const uint8_t* masks, size_t count, unsigned char* out) {
+    // WallBits already match the nibble layout, so no per-cell translation
+    size_t pairs = count / 2;
+    for (size_t i = 0; i < pairs; i++) {
+        out[i] = static_cast<unsigned char>((masks[2 * i] & 0x0f) | (masks[2 * i + 1] << 4));
+    }
+    if (count % 2 == 1) out[pairs] = masks[count - 1] & 0x0f;
+}
+
+bool saveMaze(const Maze& maze, const std::string& filename, std::string* error) {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        setError(error, "cannot open " + filename + " for writing");
+        return false;
+    }
+
+    out.write(magic, 4);
+    writeU32(out, formatVersion);
+    writeU32(out, static_cast<uint32_t>(maze.getWidth()));
+    writeU32(out, static_cast<uint32_t>(maze.getHeight()));
+
+    // Pack a block of cells at a time so memory stays bounded; blocks hold
+    // an even number of cells, so only the last byte can be half full
+    const size_t blockCells = 1 << 16;
+    const uint8_t* masks = maze.wallMasks();
+    size_t cells = static_cast<size_t>(maze.getWidth()) * maze.getHeight();
+    std::vector<unsigned char> packed((std::min(cells, blockCells) + 1) / 2);
+    for (size_t first = 0; first < cells; first += blockCells) {
+        size_t count = std::min(blockCells, cells - first);
+        packWallMasks(masks + first, count, packed.data());
+        out.write(reinterpret_cast<const char*>(packed.data()), (count + 1) / 2);
+    }
+
+    if (!out) {
+        setError(error, "failed writing " + filename);
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<Maze> loadMaze(const std::string& filename, std::string* error) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) {
+        setError(error, "cannot open " + filename);
+        return nullptr;
+    }
+
+    char header[4];
+    uint32_t version, width, height;
+    if (!in.read(header, 4) || std::memcmp(header, magic, 4) != 0) {
+        setError(error, filename + " is not a maze file");
+        return nullptr;
+    }
+    if (!readU32(in, version) || version != formatVersion) {
+        setError(error, filename + " has an unsupported format version");
+        return nullptr;
+    }
+    if (!readU32(in, width) || !readU32(in, height) || width == 0 || height == 0
+        || width > 0x7fffffff || height > 0x7fffffff
+        || static_cast<uint64_t>(width) * height > 0x7fffffff) {
+        setError(error, filename + " has an invalid size");
+        return nullptr;
+    }
+
+    // Check the walls are all there before allocating for them, so a
+    // corrupt header cannot ask for gigabytes
+    uint64_t cells = static_cast<uint64_t>(width) * height;
+    std::streampos body = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streamoff remaining = in.tellg() - body;
+    in.seekg(body);
+    if (!in || remaining < 0 || static_cast<uint64_t>(remaining) < (cells + 1) / 2) {
+        setError(error, filename + " is truncated");
+        return nullptr;
+    }
+
+    std::vector<unsigned char> packed((cells + 1) / 2);
+    if (!in.read(reinterpret_cast<char*>(packed.data()), packed.size())) {
+        setError(error, filename + " is truncated");
+        return nullptr;
+    }
+
+    auto maze = std::make_unique<Maze>(static_cast<int>(width), static_cast<int>(height));
+
+    uint64_t cell = 0;
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++, cell++) {
+            unsigned char byte = packed[cell / 2];
+            unsigned char bits = cell % 2 == 0 ? (byte & 0x0f) : (byte >> 4);
+            maze->setCell(static_cast<int>(x), static_cast<int>(y), unpackCell(bits));
+        }
+    }
+    return maze;
+}
@@ -0,0 +1,24 @@
+#ifndef MAZEIO_H
+#define MAZEIO_H
+
+#include <memory>
+#include <string>
+#include "maze.h"
+
+// Binary maze file: "MAZE" magic, format version, little-endian 32-bit
+// width and height, then one nibble of wall bits per cell in row-major
+// order (bit 0 = top, 1 = right, 2 = bottom, 3 = left), two cells a byte.
+bool saveMaze(const Maze& maze, const std::string& filename, std::string* error = nullptr);
+
+// Returns nullptr (and fills error if given) when the file is unreadable
+std::unique_ptr<Maze> loadMaze(const std::string& filename, std::string* error = nullptr);
+
+// One cell's walls as a nibble in the layout above, and back
+unsigned char packCell(const Cell& cell);
+Cell unpackCell(unsigned char bits);
+
+// count wall masks (Maze::wallMasks() order and bits) packed two a byte,
+// low nibble first, into the (count + 1) / 2 bytes at out
+void packWallMasks(const uint8_t* masks, size_t count, unsigned char* out);
+
+#endif // MAZEIO_H
@@ -0,0 +1,460 @@
+#include "mazereplay.h"
+#include "mazeio.h"
+#include "mazeutil.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+const char magic[4] = {'M', 'Z', 'R', 'P'};
+const uint32_t formatVersion = 1;
+const int nameLimit = 255;
+
+void putU32(std::string& out, uint32_t value) {
+    char bytes[4] = {
+        static_cast<char>(value), static_cast<char>(value >> 8),
+        static_cast<char>(value >> 16), static_cast<char>(value >> 24)
+    };
+    out.append(bytes, 4);
+}
+
+void putU64(std::string& out, uint64_t value) {
+    putU32(out, static_cast<uint32_t>(value));
+    putU32(out, static_cast<uint32_t>(value >> 32));
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t zigzag(int64_t delta) {
+    return (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Move code from cell a to neighbouring cell b, or -1 when b is not a
+// neighbour (numbering as in Maze::hasWall)
+int moveCode(uint32_t a, uint32_t b, uint32_t width) {
+    if (b + width == a) return 0;
+    if (b == a + 1 && b % width != 0) return 1;
+    if (b == a + width) return 2;
+    if (b + 1 == a && a % width != 0) return 3;
+    return -1;
+}
+
+// Bounds-checked little-endian reader over a whole file
+class Reader {
+private:
+    const std::vector<char>& data;
+    size_t pos = 0;
+
+public:
+    explicit Reader(const std::vector<char>& d) : data(d) {}
+
+    bool has(size_t n) const { return data.size() - pos >= n; }
+
+    bool u32(uint32_t& value) {
+        if (!has(4)) return false;
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data() + pos);
+        value = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        pos += 4;
+        return true;
+    }
+
+    bool u64(uint64_t& value) {
+        uint32_t low, high;
+        if (!u32(low) || !u32(high)) return false;
+        value = low | (static_cast<uint64_t>(high) << 32);
+        return true;
+    }
+
+    bool bytes(void* out, size_t n) {
+        if (!has(n)) return false;
+        if (n == 0) return true;
+        std::memcpy(out, data.data() + pos, n);
+        pos += n;
+        return true;
+    }
+};
+
+// Encodes values segment by segment; moves apply to Cells tracks only
+template <typename Value>
+void encodeTrack(ReplayTrack::Kind kind, int width, size_t count, Value valueAt,
+                 std::vector<ReplayTrack::Keyframe>& keyframes, std::vector<uint8_t>& bytes) {
+    const size_t interval = static_cast<size_t>(ReplayTrack::KeyframeInterval);
+    keyframes.reserve((count + interval - 1) / interval);
+
+    for (size_t first = 0; first < count; first += interval) {
+        size_t last = std::min(count, first + interval);
+        keyframes.push_back({bytes.size(), valueAt(first)});
+
+        size_t i = first + 1;
+        while (i < last) {
+            if (kind == ReplayTrack::Kind::Cells) {
+                // Run of neighbour moves, then at most one jump
+                size_t run = 0;
+                while (i + run < last &&
+                       moveCode(valueAt(i + run - 1), valueAt(i + run), static_cast<uint32_t>(width)) >= 0) {
+                    run++;
+                }
+                putVarint(bytes, run);
+                size_t base = bytes.size();
+                bytes.resize(base + (run + 3) / 4, 0);
+                for (size_t k = 0; k < run; k++) {
+                    int code = moveCode(valueAt(i + k - 1), valueAt(i + k), static_cast<uint32_t>(width));
+                    bytes[base + k / 4] |= static_cast<uint8_t>(code << (2 * (k % 4)));
+                }
+                i += run;
+                if (i >= last) break;
+            }
+            putVarint(bytes, zigzag(static_cast<int64_t>(valueAt(i)) - static_cast<int64_t>(valueAt(i - 1))));
+            i++;
+        }
+    }
+}
+
+} // namespace
+
+ReplayTrack::ReplayTrack(Kind k, int w) : kind(k), width(w), steps(0) {}
+
+ReplayTrack ReplayTrack::fromWalls(const std::pmr::vector<Wall>& walls, int width) {
+    ReplayTrack track(Kind::Walls, width);
+    track.steps = static_cast<long long>(walls.size());
+    auto slot = [&](size_t i) {
+        const Wall& wall = walls[i];
+        int x = std::min(wall.x1, wall.x2), y = std::min(wall.y1, wall.y2);
+        return static_cast<uint32_t>((static_cast<uint32_t>(y) * width + x) * 2 + (wall.x1 == wall.x2 ? 1 : 0));
+    };
+    encodeTrack(Kind::Walls, width, walls.size(), slot, track.keyframes, track.bytes);
+    return track;
+}
+
+ReplayTrack ReplayTrack::fromCells(const std::pmr::vector<std::pair<int, int>>& cells, int width) {
+    ReplayTrack track(Kind::Cells, width);
+    track.steps = static_cast<long long>(cells.size());
+    auto index = [&](size_t i) {
+        return static_cast<uint32_t>(cells[i].second) * width + static_cast<uint32_t>(cells[i].first);
+    };
+    encodeTrack(Kind::Cells, width, cells.size(), index, track.keyframes, track.bytes);
+    return track;
+}
+
+ReplayTrack ReplayTrack::fromEncoded(Kind kind, int width, long long steps,
+                                     std::vector<Keyframe> keyframes, std::vector<uint8_t> bytes) {
+    ReplayTrack track(kind, width);
+    track.steps = steps;
+    track.keyframes = std::move(keyframes);
+    track.bytes = std::move(bytes);
+    return track;
+}
+
+long long ReplayTrack::encodedBytes() const {
+    return static_cast<long long>(bytes.size() + keyframes.size() * (8 + 4)) + 16;
+}
+
+ReplayCursor::ReplayCursor(const ReplayTrack* t)
+    : track(t), step(0), pos(0), value(0), runBytes(0), runIndex(0), runLength(0),
+      needHeader(true), corrupt(false) {}
+
+bool ReplayCursor::readVarint(uint64_t& out) {
+    out = 0;
+    const std::vector<uint8_t>& bytes = track->bytes;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= bytes.size()) break;
+        uint8_t byte = bytes[pos++];
+        out |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    corrupt = true;
+    return false;
+}
+
+void ReplayCursor::seek(long long target) {
+    if (!track) return;
+    step = std::max(0LL, std::min(target, track->steps)) / ReplayTrack::KeyframeInterval
+         * ReplayTrack::KeyframeInterval;
+    while (step < target && !atEnd()) {
+        next();
+    }
+}
+
+uint32_t ReplayCursor::next() {
+    if (atEnd()) return value;
+
+    if (step % ReplayTrack::KeyframeInterval == 0) {
+        const ReplayTrack::Keyframe& key = track->keyframes[static_cast<size_t>(step / ReplayTrack::KeyframeInterval)];
+        pos = static_cast<size_t>(key.offset);
+        value = key.value;
+        needHeader = true;
+        runIndex = runLength = 0;
+        step++;
+        return value;
+    }
+
+    uint64_t raw;
+    if (track->kind == ReplayTrack::Kind::Cells) {
+        if (needHeader) {
+            uint64_t length = 0;
+            readVarint(length);
+            runLength = static_cast<long long>(std::min<uint64_t>(length, track->bytes.size() * 4));
+            runIndex = 0;
+            runBytes = pos;
+            pos += static_cast<size_t>((runLength + 3) / 4);
+            needHeader = false;
+            if (pos > track->bytes.size()) corrupt = true;
+        }
+        if (runIndex < runLength) {
+            size_t at = runBytes + static_cast<size_t>(runIndex / 4);
+            int code = at < track->bytes.size() ? (track->bytes[at] >> (2 * (runIndex % 4))) & 3 : 0;
+            uint32_t width = static_cast<uint32_t>(track->width);
+            switch (code) {
+                case 0: value -= width; break;
+                case 1: value += 1; break;
+                case 2: value += width; break;
+                case 3: value -= 1; break;
+            }
+            runIndex++;
+            step++;
+            return value;
+        }
+        needHeader = true;
+    }
+
+    readVarint(raw);
+    value = static_cast<uint32_t>(static_cast<int64_t>(value) + unzigzag(raw));
+    step++;
+    return value;
+}
+
+long long MazeReplay::encodedBytes() const {
+    return walls.encodedBytes() + explored.encodedBytes() + path.encodedBytes()
+         + static_cast<long long>(finalWalls.size());
+}
+
+long long MazeReplay::rawBytes() const {
+    return walls.size() * static_cast<long long>(sizeof(Wall))
+         + (explored.size() + path.size()) * static_cast<long long>(sizeof(std::pair<int, int>));
+}
+
+void MazeReplay::recordSolve(const PathResult& result, const std::string& name,
+                             int sx, int sy, int ex, int ey) {
+    algorithm = name;
+    found = result.found;
+    startX = sx;
+    startY = sy;
+    endX = ex;
+    endY = ey;
+    explored = ReplayTrack::fromCells(result.explored, width);
+    path = ReplayTrack::fromCells(result.path, width);
+}
+
+std::unique_ptr<Maze> MazeReplay::buildMaze() const {
+    auto maze = std::make_unique<Maze>(width, height);
+    if (!finalWalls.empty()) {
+        size_t cell = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++, cell++) {
+                uint8_t byte = finalWalls[cell / 2];
+                maze->setCell(x, y, unpackCell(cell % 2 == 0 ? (byte & 0x0f) : (byte >> 4)));
+            }
+        }
+        return maze;
+    }
+
+    ReplayCursor cursor(&walls);
+    while (!cursor.atEnd()) {
+        uint32_t slot = cursor.next();
+        uint32_t cell = slot / 2;
+        maze->setWall(static_cast<int>(cell % width), static_cast<int>(cell / width), slot % 2 ? 2 : 1, false);
+    }
+    return maze;
+}
+
+MazeReplay recordReplay(const Maze& maze) {
+    MazeReplay replay;
+    replay.width = maze.getWidth();
+    replay.height = maze.getHeight();
+    replay.seed = maze.getSeed();
+    replay.stream = maze.getStream();
+    replay.endX = replay.width - 1;
+    replay.endY = replay.height - 1;
+    replay.walls = ReplayTrack::fromWalls(maze.getWallRemovalOrder(), replay.width);
+
+    // Mazes loaded from disk or edited after generation are not the sum of
+    // their removals; store their walls outright
+    size_t cells = static_cast<size_t>(replay.width) * replay.height;
+    std::unique_ptr<Maze> rebuilt = replay.buildMaze();
+    if (std::memcmp(rebuilt->wallMasks(), maze.wallMasks(), cells) != 0) {
+        replay.finalWalls.resize((cells + 1) / 2);
+        packWallMasks(maze.wallMasks(), cells, replay.finalWalls.data());
+    }
+    return replay;
+}
+
+bool saveReplay(const MazeReplay& replay, const std::string& filename, std::string* error) {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        setError(error, "cannot open " + filename + " for writing");
+        return false;
+    }
+
+    std::string header(magic, 4);
+    putU32(header, formatVersion);
+    putU32(header, static_cast<uint32_t>(replay.width));
+    putU32(header, static_cast<uint32_t>(replay.height));
+    putU32(header, replay.seed);
+    putU64(header, replay.stream);
+    std::string name = replay.algorithm.substr(0, nameLimit);
+    header.push_back(static_cast<char>((replay.hasSolve() ? 1 : 0) | (replay.found ? 2 : 0) |
+                                       (replay.finalWalls.empty() ? 0 : 4)));
+    header.push_back(static_cast<char>(name.size()));
+    header += name;
+    putU32(header, static_cast<uint32_t>(replay.startX));
+    putU32(header, static_cast<uint32_t>(replay.startY));
+    putU32(header, static_cast<uint32_t>(replay.endX));
+    putU32(header, static_cast<uint32_t>(replay.endY));
+    out.write(header.data(), header.size());
+    out.write(reinterpret_cast<const char*>(replay.finalWalls.data()), replay.finalWalls.size());
+
+    for (const ReplayTrack* track : {&replay.walls, &replay.explored, &replay.path}) {
+        std::string table;
+        putU64(table, static_cast<uint64_t>(track->size()));
+        putU64(table, track->getBytes().size());
+        for (const ReplayTrack::Keyframe& key : track->getKeyframes()) {
+            putU64(table, key.offset);
+            putU32(table, key.value);
+        }
+        out.write(table.data(), table.size());
+        out.write(reinterpret_cast<const char*>(track->getBytes().data()), track->getBytes().size());
+    }
+
+    if (!out) {
+        setError(error, "failed writing " + filename);
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<MazeReplay> loadReplay(const std::string& filename, std::string* error) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) {
+        setError(error, "cannot open " + filename);
+        return nullptr;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    Reader reader(data);
+
+    char fileMagic[4];
+    uint32_t version = 0;
+    if (!reader.bytes(fileMagic, 4) || std::memcmp(fileMagic, magic, 4) != 0) {
+        setError(error, filename + " is not a maze replay");
+        return nullptr;
+    }
+    if (!reader.u32(version) || version != formatVersion) {
+        setError(error, filename + " has an unsupported format version");
+        return nullptr;
+    }
+
+    auto replay = std::make_unique<MazeReplay>();
+    uint32_t width, height, seed, start[4];
+    uint64_t stream;
+    unsigned char flags[2];
+    char name[nameLimit];
+    if (!reader.u32(width) || !reader.u32(height) || !reader.u32(seed) || !reader.u64(stream) ||
+        !reader.bytes(flags, 2) || !reader.bytes(name, flags[1]) ||
+        !reader.u32(start[0]) || !reader.u32(start[1]) || !reader.u32(start[2]) || !reader.u32(start[3])) {
+        setError(error, filename + " is truncated");
+        return nullptr;
+    }
+    if (width == 0 || height == 0 || width > 0x7fffffff || height > 0x7fffffff ||
+        static_cast<uint64_t>(width) * height > 0x7fffffff) {
+        setError(error, filename + " has an invalid maze size");
+        return nullptr;
+    }
+
+    replay->width = static_cast<int>(width);
+    replay->height = static_cast<int>(height);
+    replay->seed = seed;
+    replay->stream = stream;
+    replay->algorithm.assign(name, flags[1]);
+    replay->found = flags[0] & 2;
+    replay->startX = static_cast<int>(start[0]);
+    replay->startY = static_cast<int>(start[1]);
+    replay->endX = static_cast<int>(start[2]);
+    replay->endY = static_cast<int>(start[3]);
+    if ((flags[0] & 1) && replay->algorithm.empty()) replay->algorithm = "?";
+
+    uint64_t cells = static_cast<uint64_t>(width) * height;
+    if (flags[0] & 4) {
+        replay->finalWalls.resize(static_cast<size_t>((cells + 1) / 2));
+        if (!reader.bytes(replay->finalWalls.data(), replay->finalWalls.size())) {
+            setError(error, filename + " is truncated");
+            return nullptr;
+        }
+    }
+
+    ReplayTrack* tracks[3] = {&replay->walls, &replay->explored, &replay->path};
+    for (ReplayTrack* track : tracks) {
+        uint64_t steps, size;
+        if (!reader.u64(steps) || !reader.u64(size)) {
+            setError(error, filename + " is truncated");
+            return nullptr;
+        }
+        uint64_t segments = steps / ReplayTrack::KeyframeInterval + (steps % ReplayTrack::KeyframeInterval != 0);
+        if (size > data.size() || segments > data.size() / 12 ||
+            !reader.has(static_cast<size_t>(segments * 12 + size))) {
+            setError(error, filename + " is truncated");
+            return nullptr;
+        }
+
+        // Every step after a segment's first costs at least one 2-bit move
+        if (steps - segments > size * 4) {
+            setError(error, filename + " has a corrupt track");
+            return nullptr;
+        }
+
+        std::vector<ReplayTrack::Keyframe> keyframes(static_cast<size_t>(segments));
+        for (ReplayTrack::Keyframe& key : keyframes) {
+            reader.u64(key.offset);
+            reader.u32(key.value);
+            if (key.offset > size) {
+                setError(error, filename + " has a corrupt keyframe table");
+                return nullptr;
+            }
+        }
+        std::vector<uint8_t> bytes(static_cast<size_t>(size));
+        reader.bytes(bytes.data(), bytes.size());
+        *track = ReplayTrack::fromEncoded(track->getKind(), replay->width, static_cast<long long>(steps),
+                                          std::move(keyframes), std::move(bytes));
+    }
+
+    // One pass over every step so playback can trust the values: cells
+    // inside the maze, and wall slots naming a wall between two cells
+    uint64_t limits[3] = {cells * 2, cells, cells};
+    for (int t = 0; t < 3; t++) {
+        ReplayCursor cursor(tracks[t]);
+        while (!cursor.atEnd()) {
+            uint32_t value = cursor.next();
+            bool inside = value < limits[t];
+            if (inside && t == 0) {
+                uint32_t cell = value / 2;
+                inside = value % 2 ? cell / width != height - 1 : cell % width != width - 1;
+            }
+            if (cursor.isCorrupt() || !inside) {
+                setError(error, filename + " has a corrupt track");
+                return nullptr;
+            }
+        }
+    }
+    return replay;
+}
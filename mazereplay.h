@@ -0,0 +1,128 @@
+#ifndef MAZEREPLAY_H
+#define MAZEREPLAY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "maze.h"
+#include "pathfinder.h"
+
+// One recorded sequence of cell indices (y * width + x) or wall slots
+// (cell * 2, plus 1 for the wall below the cell rather than to its right).
+// Steps are cut into segments of KeyframeInterval. A segment starts from an
+// absolute value held in the keyframe table, so decoding can begin at any
+// segment without reading the bytes before it. Inside a segment:
+//   Walls: one zigzag varint delta per step.
+//   Cells: groups of varint run length, the run as 2-bit moves (0 = up,
+//          1 = right, 2 = down, 3 = left) four a byte, then a zigzag varint
+//          delta for the next step when it is not a neighbour.
+class ReplayTrack {
+public:
+    enum class Kind { Walls, Cells };
+    static constexpr long long KeyframeInterval = 4096;
+
+    struct Keyframe {
+        uint64_t offset;    // first byte of the segment
+        uint32_t value;     // absolute value of its first step
+    };
+
+private:
+    Kind kind;
+    int width;
+    long long steps;
+    std::vector<Keyframe> keyframes;
+    std::vector<uint8_t> bytes;
+
+    friend class ReplayCursor;
+
+public:
+    explicit ReplayTrack(Kind kind = Kind::Cells, int width = 0);
+
+    static ReplayTrack fromWalls(const std::pmr::vector<Wall>& walls, int width);
+    static ReplayTrack fromCells(const std::pmr::vector<std::pair<int, int>>& cells, int width);
+    // Adopts already encoded data, e.g. read back from a file
+    static ReplayTrack fromEncoded(Kind kind, int width, long long steps,
+                                   std::vector<Keyframe> keyframes, std::vector<uint8_t> bytes);
+
+    Kind getKind() const { return kind; }
+    long long size() const { return steps; }
+    bool empty() const { return steps == 0; }
+    const std::vector<Keyframe>& getKeyframes() const { return keyframes; }
+    const std::vector<uint8_t>& getBytes() const { return bytes; }
+    // Encoded size, keyframe table included
+    long long encodedBytes() const;
+};
+
+// Sequential decoder over a ReplayTrack. seek() starts from the nearest
+// keyframe, so it costs at most KeyframeInterval steps of decoding.
+class ReplayCursor {
+private:
+    const ReplayTrack* track;
+    long long step;
+    size_t pos;             // next unread byte
+    uint32_t value;
+    size_t runBytes;        // first byte of the current run's moves
+    long long runIndex;     // moves of the current run already decoded
+    long long runLength;
+    bool needHeader;
+    bool corrupt;
+
+    bool readVarint(uint64_t& out);
+
+public:
+    explicit ReplayCursor(const ReplayTrack* track = nullptr);
+
+    void seek(long long step);
+    long long position() const { return step; }
+    bool atEnd() const { return !track || step >= track->steps; }
+    // Set once a read ran off the encoded bytes; later values are garbage
+    bool isCorrupt() const { return corrupt; }
+
+    // Value at position(), then advance by one step
+    uint32_t next();
+};
+
+// A generation and, optionally, one solve, as recorded from a Maze and a
+// PathResult. Playing it back needs neither the generator nor the solver.
+struct MazeReplay {
+    int width = 0, height = 0;
+    unsigned int seed = 0;
+    uint64_t stream = 0;
+    std::string algorithm;      // solver name; empty when no solve was recorded
+    bool found = false;
+    int startX = 0, startY = 0, endX = 0, endY = 0;
+    ReplayTrack walls{ReplayTrack::Kind::Walls};
+    ReplayTrack explored;
+    ReplayTrack path;
+    // Walls packed as in mazeio, kept only when replaying the removals does
+    // not rebuild the maze (loaded or hand-edited mazes)
+    std::vector<uint8_t> finalWalls;
+
+    bool hasSolve() const { return !algorithm.empty(); }
+    long long totalSteps() const { return walls.size() + explored.size() + path.size(); }
+    long long encodedBytes() const;
+    // Size of the same recording as Wall and (x, y) vectors in memory
+    long long rawBytes() const;
+
+    void recordSolve(const PathResult& result, const std::string& algorithm,
+                     int startX, int startY, int endX, int endY);
+    // The maze as it stood when recorded (walls only)
+    std::unique_ptr<Maze> buildMaze() const;
+};
+
+MazeReplay recordReplay(const Maze& maze);
+
+// Replay file: "MZRP", format version, then little-endian u32 width,
+// height, seed, u64 stream, u8 flags (1 = solved, 2 = path found,
+// 4 = final walls stored), u8 name length and the algorithm name, u32 start
+// x, y, end x, y, the packed final walls when flagged, and the walls,
+// explored and path tracks. Each track is u64 steps, u64 encoded bytes,
+// one (u64 offset, u32 value) keyframe per segment and the encoded bytes.
+bool saveReplay(const MazeReplay& replay, const std::string& filename, std::string* error = nullptr);
+
+// Returns nullptr (and fills error if given) when the file is unreadable.
+// Every track is decoded once to check its values stay inside the maze.
+std::unique_ptr<MazeReplay> loadReplay(const std::string& filename, std::string* error = nullptr);
+
+#endif // MAZEREPLAY_H
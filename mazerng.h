@@ -0,0 +1,71 @@
+#ifndef MAZERNG_H
+#define MAZERNG_H
+
+#include <cstdint>
+#include <utility>
+
+// Counter-based random generator: draw n of stream s is a pure function of
+// (seed, s, n), the SplitMix64 mix of a per-stream key plus n times the
+// golden-ratio increment. Streams need no shared state, so maze i of a batch
+// can be generated on any thread and still come out identical. Unlike
+// std::mt19937 plus std::shuffle, the output is the same on every standard
+// library.
+class CounterRng {
+private:
+    static constexpr uint64_t Gamma = 0x9e3779b97f4a7c15ULL;
+
+    uint64_t key;
+    uint64_t counter;
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit CounterRng(uint64_t seed, uint64_t stream = 0)
+        : key(mix(seed ^ mix(stream * Gamma + Gamma))), counter(0) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~0ULL; }
+
+    result_type operator()() { return mix(key + (++counter) * Gamma); }
+
+    // Uniform in [0, bound), bound > 0. Lemire's multiply-shift with
+    // rejection for 32-bit bounds, plain rejection above that.
+    uint64_t below(uint64_t bound) {
+        if (bound <= 0xffffffffULL) {
+            uint32_t range = static_cast<uint32_t>(bound);
+            uint64_t product = static_cast<uint64_t>(static_cast<uint32_t>((*this)())) * range;
+            uint32_t low = static_cast<uint32_t>(product);
+            if (low < range) {
+                uint32_t threshold = static_cast<uint32_t>(-range) % range;
+                while (low < threshold) {
+                    product = static_cast<uint64_t>(static_cast<uint32_t>((*this)())) * range;
+                    low = static_cast<uint32_t>(product);
+                }
+            }
+            return product >> 32;
+        }
+        uint64_t limit = max() - max() % bound;
+        uint64_t value;
+        do {
+            value = (*this)();
+        } while (value >= limit);
+        return value % bound;
+    }
+};
+
+// Fisher-Yates shuffle driven by CounterRng
+template <typename RandomIt>
+void shuffleRange(RandomIt first, RandomIt last, CounterRng& rng) {
+    for (auto i = last - first - 1; i > 0; i--) {
+        auto j = static_cast<decltype(i)>(rng.below(static_cast<uint64_t>(i) + 1));
+        std::swap(first[i], first[j]);
+    }
+}
+
+#endif // MAZERNG_H
@@ -1,25 +1,58 @@
 #include "mazescene.h"
+#include "tracer.h"
 #include <QPainter>
 #include <QGraphicsLineItem>
+#include <QGraphicsSceneMouseEvent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Blend the colors of every lane whose bit is set in visits
+QColor mixRaceColors(unsigned int visits) {
+    int r = 0, g = 0, b = 0, count = 0;
+    for (int lane = 0; visits != 0; lane++, visits >>= 1) {
+        if (visits & 1) {
+            QColor c = MazeScene::raceColor(lane);
+            r += c.red();
+            g += c.green();
+            b += c.blue();
+            count++;
+        }
+    }
+    return count ? QColor(r / count, g / count, b / count) : QColor(Qt::white);
+}
+
+} // namespace
 
 MazeScene::MazeScene(int w, int h, QObject* parent)
-    : QGraphicsScene(parent), cellSize(40), animationStep(0), 
-      pathStep(0), showingPath(false) {
+    : QGraphicsScene(parent), cellSize(40), animationStep(0), maxSteps(0),
+      animationMode(AnimationMode::None), speedMultiplier(1), stepCredit(0.0),
+      currentFromCache(false), solutionCache(nullptr), pathStep(0), showingPath(false),
+      replayStep(0), replayPhase(0) {
     
     maze = new Maze(w, h);
     animationTimer = new QTimer(this);
-    connect(animationTimer, &QTimer::timeout, this, &MazeScene::animateGeneration);
+    connect(animationTimer, &QTimer::timeout, this, &MazeScene::onAnimationFrame);
     
     setSceneRect(0, 0, w * cellSize, h * cellSize);
     drawMaze();
 }
 
 MazeScene::~MazeScene() {
+    stopRace();  // solver threads read the maze
     delete maze;
 }
 
+void MazeScene::setAnimationSpeed(int multiplier) {
+    speedMultiplier = std::max(0, multiplier);
+}
+
 void MazeScene::generateNewMaze() {
-    clear();
+    stopAnimation();
+    stopRace();
+    stopReplay();
+    connectivity.reset();
     maze->generateMaze(maze->getWidth() * maze->getHeight() / 20); // Add some cycles
     
     const auto& walls = maze->getWallRemovalOrder();
@@ -27,21 +60,117 @@ void MazeScene::generateNewMaze() {
     animationStep = 0;
     showingPath = false;
     
-    // Draw initial maze with all walls
-    for (int y = 0; y < maze->getHeight(); y++) {
-        for (int x = 0; x < maze->getWidth(); x++) {
-            drawCell(x, y, Qt::white);
+    drawMaze();
+    startAnimation(AnimationMode::Generation);
+}
+
+void MazeScene::startAnimation(AnimationMode mode) {
+    animationMode = mode;
+    stepCredit = 0.0;
+    frameClock.start();
+    animationTimer->start(FrameIntervalMs);
+}
+
+void MazeScene::stopAnimation() {
+    animationTimer->stop();
+    animationMode = AnimationMode::None;
+    stepCredit = 0.0;
+}
+
+double MazeScene::currentStepRate() const {
+    bool generating = animationMode == AnimationMode::Generation ||
+                      (animationMode == AnimationMode::Replay && replayStep < replay->walls.size());
+    int base = generating ? GenerationStepsPerSecond : PathfindingStepsPerSecond;
+    return static_cast<double>(base) * speedMultiplier;
+}
+
+void MazeScene::onAnimationFrame() {
+    TRACE_SCOPE("scene", "animation frame");
+    QElapsedTimer budget;
+    budget.start();
+
+    // Work out how many steps this frame owes from the real time elapsed,
+    // so the speed does not depend on timer jitter
+    qint64 elapsedNs = frameClock.nsecsElapsed();
+    frameClock.restart();
+
+    long long due;
+    if (animationMode == AnimationMode::Replay && speedMultiplier == 0) {
+        due = replay->totalSteps() - replayStep;
+    } else if (speedMultiplier == 0) {
+        due = maxSteps + static_cast<long long>(getCurrentPath().explored.size());
+    } else {
+        stepCredit += currentStepRate() * elapsedNs / 1e9;
+        due = static_cast<long long>(stepCredit);
+        stepCredit -= due;
+    }
+
+    // Advance as many steps as are due, but never past the frame budget.
+    // All brush changes land in one scene update, so the view repaints once.
+    bool running = true;
+    for (long long i = 0; i < due && running; i++) {
+        switch (animationMode) {
+            case AnimationMode::Generation: running = animateGeneration(); break;
+            case AnimationMode::Pathfinding: running = animatePathfinding(); break;
+            case AnimationMode::Race: running = animateRace(); break;
+            case AnimationMode::Replay: running = animateReplay(); break;
+            case AnimationMode::None: running = false; break;
+        }
+        if ((i & 63) == 63 && budget.nsecsElapsed() >= FrameBudgetNs) {
+            // Out of budget: drop the backlog rather than stall later frames
+            stepCredit = 0.0;
+            break;
         }
     }
     
-    // Start animation
-    animationTimer->start(10);
+    if (!running && animationMode == AnimationMode::Pathfinding) {
+        finishPathfinding();
+    }
+    if (animationMode == AnimationMode::Race) {
+        if (!running) finishRace();
+        emit raceProgress();
+    }
+    if (animationMode == AnimationMode::Pathfinding) {
+        currentStats.renderNs += budget.nsecsElapsed();
+    }
+    if (animationMode == AnimationMode::Replay) {
+        emit replayProgress();
+    }
+
+    if (!running) {
+        stopAnimation();
+        emit animationFinished();
+    }
+}
+
+void MazeScene::skipAnimation() {
+    TRACE_SCOPE("scene", "skip animation");
+    if (!isAnimating()) return;
+
+    if (animationMode == AnimationMode::Generation) {
+        while (animateGeneration()) {}
+    } else if (animationMode == AnimationMode::Replay) {
+        seekReplay(replay->totalSteps());
+    } else if (animationMode == AnimationMode::Race) {
+        race->wait();
+        while (animateRace()) {}
+        finishRace();
+        emit raceProgress();
+    } else {
+        QElapsedTimer renderTimer;
+        renderTimer.start();
+        while (animatePathfinding()) {}
+        finishPathfinding();
+        currentStats.renderNs += renderTimer.nsecsElapsed();
+    }
+
+    stopAnimation();
+    emit animationFinished();
 }
 
-void MazeScene::animateGeneration() {
+bool MazeScene::animateGeneration() {
     if (animationStep >= maxSteps) {
-        animationTimer->stop();
-        return;
+        return false;
     }
     
     const auto& walls = maze->getWallRemovalOrder();
@@ -52,17 +181,30 @@ void MazeScene::animateGeneration() {
     drawCell(wall.x2, wall.y2, QColor(200, 200, 255));
     
     animationStep++;
+    return true;
 }
 
 void MazeScene::solveMazeWithBFS() {
-    if (animationTimer->isActive()) return;
+    solveWith(Algorithm::BFS);
+}
+
+void MazeScene::solveMazeWithDFS() {
+    solveWith(Algorithm::DFS);
+}
+
+void MazeScene::solveWith(Algorithm algorithm) {
+    if (isAnimating()) return;
+
+    QElapsedTimer renderTimer;
+    renderTimer.start();
     
     // Clear previous solution visualization
-    clear();
-    drawMaze();
+    clearSolution();
     
     showingPath = true;
-    solvingAlgorithm = "BFS";
+    for (const AlgorithmInfo& info : PathFinder::algorithms()) {
+        if (info.id == algorithm) solvingAlgorithm = info.name;
+    }
     pathStep = 0;
     
     int startX = 0, startY = 0;
@@ -72,123 +214,458 @@ void MazeScene::solveMazeWithBFS() {
     drawCell(startX, startY, QColor(0, 0, 255));
     drawCell(endX, endY, QColor(255, 0, 0));
     
-    PathFinder pf(maze, startX, startY, endX, endY);
-    currentPath = pf.solveBFS();
+    qint64 setupNs = renderTimer.nsecsElapsed();
+    if (solutionCache) {
+        // Same maze and endpoints as an earlier press: reuse that search
+        currentPath = solutionCache->solve(*maze, algorithm, startX, startY, endX, endY, &currentFromCache);
+    } else {
+        PathFinder pf(maze, startX, startY, endX, endY);
+        currentPath = std::make_shared<const PathResult>(pf.solve(algorithm));
+        currentFromCache = false;
+    }
+    currentStats = currentPath->stats;
+    currentStats.renderNs = setupNs;
     
-    animationTimer->disconnect();
-    connect(animationTimer, &QTimer::timeout, this, &MazeScene::animatePathfinding);
-    animationTimer->start(50);
+    maxSteps = 0;
+    startAnimation(AnimationMode::Pathfinding);
 }
 
-void MazeScene::solveMazeWithDFS() {
-    if (animationTimer->isActive()) return;
+const PathResult& MazeScene::getCurrentPath() const {
+    static const PathResult none;
+    return currentPath ? *currentPath : none;
+}
     
-    // Clear previous solution visualization
-    clear();
-    drawMaze();
+bool MazeScene::animatePathfinding() {
+    const PathResult& result = getCurrentPath();
+    if (pathStep >= static_cast<int>(result.explored.size())) {
+        return false;
+    }
+
+    auto [x, y] = result.explored[pathStep];
+    drawCell(x, y, QColor(255, 200, 0));
+    pathStep++;
+    return true;
+}
+
+void MazeScene::finishPathfinding() {
+    TRACE_SCOPE("scene", "draw path");
+    // Draw final path
+    for (auto [x, y] : getCurrentPath().path) {
+        drawCell(x, y, QColor(0, 255, 0));
+    }
+
+    // Draw start and end
+    drawCell(0, 0, QColor(0, 0, 255));
+    drawCell(maze->getWidth() - 1, maze->getHeight() - 1, QColor(255, 0, 0));
+}
+
+QColor MazeScene::raceColor(int lane) {
+    static const QColor colors[] = {
+        QColor(80, 140, 255),   // blue
+        QColor(255, 150, 40),   // orange
+        QColor(170, 90, 220),   // purple
+        QColor(40, 190, 170),   // teal
+        QColor(230, 80, 120)    // pink
+    };
+    return colors[lane % 5];
+}
+
+void MazeScene::startRace() {
+    if (isAnimating()) return;
+
+    clearSolution();
     
     showingPath = true;
-    solvingAlgorithm = "DFS";
-    pathStep = 0;
+    solvingAlgorithm = "Race";
     
-    int startX = 0, startY = 0;
     int endX = maze->getWidth() - 1, endY = maze->getHeight() - 1;
-    
-    // Draw start and end points before animation
-    drawCell(startX, startY, QColor(0, 0, 255));
+    drawCell(0, 0, QColor(0, 0, 255));
     drawCell(endX, endY, QColor(255, 0, 0));
     
-    PathFinder pf(maze, startX, startY, endX, endY);
-    currentPath = pf.solveDFS();
+    size_t cells = static_cast<size_t>(maze->getWidth()) * maze->getHeight();
+    race = std::make_unique<SolverRace>(maze, 0, 0, endX, endY);
+    raceDrawn.assign(race->laneCount(), 0);
+    raceVisits.assign(cells, 0);
     
-    animationTimer->disconnect();
-    connect(animationTimer, &QTimer::timeout, this, &MazeScene::animatePathfinding);
-    animationTimer->start(50);
+    // Upper bound on steps per lane, used when running unthrottled
+    maxSteps = static_cast<int>(cells);
+    race->start();
+    startAnimation(AnimationMode::Race);
 }
 
-void MazeScene::animatePathfinding() {
-    if (pathStep >= static_cast<int>(currentPath.explored.size())) {
-        // Draw final path
-        for (auto [x, y] : currentPath.path) {
-            drawCell(x, y, QColor(0, 255, 0));
+bool MazeScene::animateRace() {
+    // Read finished first: once every lane reports done, its counts are final
+    bool pending = !race->isFinished();
+
+    for (int i = 0; i < race->laneCount(); i++) {
+        const RaceLane& lane = race->lane(i);
+        long long available = lane.progress.exploredCount.load(std::memory_order_acquire);
+        if (raceDrawn[i] < available) {
+            const std::pair<int, int>* cells = lane.progress.explored.load(std::memory_order_acquire);
+            auto [x, y] = cells[raceDrawn[i]++];
+            unsigned int& visits = raceVisits[static_cast<size_t>(y) * maze->getWidth() + x];
+            visits |= 1u << i;
+            drawCell(x, y, mixRaceColors(visits));
         }
+        if (raceDrawn[i] < available) pending = true;
+    }
+    return pending;
+}
         
-        // Draw start and end
-        drawCell(0, 0, QColor(0, 0, 255));
-        drawCell(maze->getWidth() - 1, maze->getHeight() - 1, QColor(255, 0, 0));
+void MazeScene::finishRace() {
+    TRACE_SCOPE("scene", "draw race paths");
+    // Each lane's path in a darker shade of its color
+    for (int i = 0; i < race->laneCount(); i++) {
+        for (auto [x, y] : race->lane(i).result.path) {
+            drawCell(x, y, raceColor(i).darker(160));
+        }
+    }
         
-        animationTimer->stop();
+    drawCell(0, 0, QColor(0, 0, 255));
+    drawCell(maze->getWidth() - 1, maze->getHeight() - 1, QColor(255, 0, 0));
+}
+
+void MazeScene::stopRace() {
+    race.reset();  // joins the solver threads
+    raceDrawn.clear();
+    raceVisits.clear();
+}
+
+void MazeScene::playReplay(std::shared_ptr<const MazeReplay> recording) {
+    if (!recording || recording->width != maze->getWidth() || recording->height != maze->getHeight()) {
         return;
     }
+    stopAnimation();
+    stopRace();
     
-    auto [x, y] = currentPath.explored[pathStep];
-    drawCell(x, y, QColor(255, 200, 0));
-    pathStep++;
+    *maze = *recording->buildMaze();
+    connectivity.reset();
+    showingPath = false;
+    currentPath.reset();
+    currentStats = SearchStats();
+    currentFromCache = false;
+    pathStep = 0;
+    solvingAlgorithm = "Replay";
+
+    replay = std::move(recording);
+    replayStep = 0;
+    replayPainted.assign(3 * static_cast<size_t>(maze->getWidth()) * maze->getHeight(), -1);
+    positionReplayCursor();
+
+    drawMaze();
+    startAnimation(AnimationMode::Replay);
+    emit replayProgress();
+}
+
+void MazeScene::resumeReplay() {
+    if (!replay || isAnimating() || replayStep >= replay->totalSteps()) return;
+    startAnimation(AnimationMode::Replay);
+}
+
+void MazeScene::stopReplay() {
+    replay.reset();
+    replayStep = 0;
+    replayPhase = 0;
+    replayCursor = ReplayCursor();
+    replayPainted.clear();
+}
+
+const ReplayTrack& MazeScene::replayTrack(int phase) const {
+    switch (phase) {
+        case 0: return replay->walls;
+        case 1: return replay->explored;
+        default: return replay->path;
+    }
+}
+
+// Points the cursor at replayStep, starting from the nearest keyframe
+void MazeScene::positionReplayCursor() {
+    long long index = replayStep;
+    replayPhase = 0;
+    while (replayPhase < 2 && index >= replayTrack(replayPhase).size()) {
+        index -= replayTrack(replayPhase).size();
+        replayPhase++;
+    }
+    replayCursor = ReplayCursor(&replayTrack(replayPhase));
+    replayCursor.seek(index);
+}
+
+bool MazeScene::animateReplay() {
+    if (replayStep >= replay->totalSteps()) {
+        return false;
+    }
+    while (replayCursor.atEnd() && replayPhase < 2) {
+        replayPhase++;
+        replayCursor = ReplayCursor(&replayTrack(replayPhase));
+    }
+
+    long long step = replayStep++;
+    paintReplayStep(replayPhase, step, replayCursor.next(), nullptr);
+    if (step == replay->walls.size() && replay->hasSolve()) {
+        // The solve starts on a clean maze, as it does live
+        redrawReplay();
+    }
+    return true;
+}
+
+// Marks the cells one step colors; draws them now, or collects them
+void MazeScene::paintReplayStep(int phase, long long step, uint32_t value, std::vector<size_t>* touched) {
+    size_t cells = replayPainted.size() / 3;
+    size_t first = phase == 0 ? value / 2 : value;
+    size_t second = phase == 0 ? first + (value % 2 ? maze->getWidth() : 1) : first;
+
+    for (size_t cell : {first, second}) {
+        long long& painted = replayPainted[phase * cells + cell];
+        if (painted < 0) painted = step;
+        if (touched) {
+            touched->push_back(cell);
+        } else {
+            drawCell(static_cast<int>(cell % maze->getWidth()), static_cast<int>(cell / maze->getWidth()),
+                     replayColor(cell));
+        }
+        if (second == first) break;
+    }
+}
+
+// Color of a cell with the first replayStep steps applied
+QColor MazeScene::replayColor(size_t cell) const {
+    size_t cells = replayPainted.size() / 3;
+    auto painted = [&](int phase) {
+        long long step = replayPainted[phase * cells + cell];
+        return step >= 0 && step < replayStep;
+    };
+
+    bool solving = replay->hasSolve() && replayStep > replay->walls.size();
+    if (solving) {
+        size_t width = static_cast<size_t>(maze->getWidth());
+        if (cell == static_cast<size_t>(replay->startY) * width + replay->startX) return QColor(0, 0, 255);
+        if (cell == static_cast<size_t>(replay->endY) * width + replay->endX) return QColor(255, 0, 0);
+    }
+    if (painted(2)) return QColor(0, 255, 0);
+    if (painted(1)) return QColor(255, 200, 0);
+    if (painted(0) && !solving) return QColor(200, 200, 255);
+    return QColor(Qt::white);
+}
+
+void MazeScene::redrawReplay() {
+    for (size_t cell = 0; cell < cellItems.size(); cell++) {
+        cellItems[cell]->setBrush(QBrush(replayColor(cell)));
+    }
+}
+
+void MazeScene::seekReplay(long long target) {
+    TRACE_SCOPE("scene", "seek replay");
+    if (!replay) return;
+    target = std::max(0LL, std::min(target, replay->totalSteps()));
+    if (target == replayStep) return;
+
+    // Decode only the steps between the two positions, each phase from its
+    // nearest keyframe. Forward steps paint; backward steps unpaint cells
+    // first colored at or after the target.
+    bool forward = target > replayStep;
+    long long from = std::min(target, replayStep), to = std::max(target, replayStep);
+    size_t cells = replayPainted.size() / 3;
+    std::vector<size_t> touched;
+    long long phaseStart = 0;
+    for (int phase = 0; phase < 3; phase++) {
+        const ReplayTrack& track = replayTrack(phase);
+        long long begin = std::max(from, phaseStart), end = std::min(to, phaseStart + track.size());
+        if (begin < end) {
+            ReplayCursor cursor(&track);
+            cursor.seek(begin - phaseStart);
+            for (long long step = begin; step < end; step++) {
+                uint32_t value = cursor.next();
+                if (forward) {
+                    paintReplayStep(phase, step, value, &touched);
+                    continue;
+                }
+                size_t first = phase == 0 ? value / 2 : value;
+                size_t second = phase == 0 ? first + (value % 2 ? maze->getWidth() : 1) : first;
+                for (size_t cell : {first, second}) {
+                    long long& painted = replayPainted[phase * cells + cell];
+                    if (painted >= target) painted = -1;
+                    touched.push_back(cell);
+                    if (second == first) break;
+                }
+            }
+        }
+        phaseStart += track.size();
+    }
+
+    replayStep = target;
+    long long walls = replay->walls.size();
+    if (replay->hasSolve() && (from > walls) != (to > walls)) {
+        // Crossed into or out of the solve: generation colors come and go
+        redrawReplay();
+    } else {
+        for (size_t cell : touched) {
+            cellItems[cell]->setBrush(QBrush(replayColor(cell)));
+        }
+    }
+    positionReplayCursor();
+    emit replayProgress();
+}
+
+bool MazeScene::saveReplay(const QString& filename, QString* error) const {
+    MazeReplay recorded;
+    if (!replay) {
+        recorded = recordReplay(*maze);
+        if (currentPath && showingPath) {
+            recorded.recordSolve(*currentPath, solvingAlgorithm.toStdString(), 0, 0,
+                                 maze->getWidth() - 1, maze->getHeight() - 1);
+        }
+    }
+
+    std::string message;
+    bool saved = ::saveReplay(replay ? *replay : recorded, filename.toStdString(), &message);
+    if (!saved && error) *error = QString::fromStdString(message);
+    return saved;
 }
 
 void MazeScene::drawMaze() {
-    // Draw all cells with walls
+    TRACE_SCOPE("scene", "draw maze");
+    clear();
+    cellItems.assign(static_cast<size_t>(maze->getWidth()) * maze->getHeight(), nullptr);
+
+    // One persistent rectangle per cell; animation only recolors these
     for (int y = 0; y < maze->getHeight(); y++) {
         for (int x = 0; x < maze->getWidth(); x++) {
-            drawCell(x, y, Qt::white);
+            cellItems[static_cast<size_t>(y) * maze->getWidth() + x] =
+                addRect(x * cellSize, y * cellSize, cellSize, cellSize,
+                        QPen(Qt::black), QBrush(Qt::white));
+        }
+    }
+
+    // Walls on top. Shared walls are stored on both cells, so the top and
+    // left walls of every cell plus the outer right/bottom edges cover all.
+    wallLines.assign(static_cast<size_t>(maze->getWidth()) * maze->getHeight() * 2, nullptr);
+    QPen wallPen(Qt::black, 2);
+    for (int y = 0; y < maze->getHeight(); y++) {
+        for (int x = 0; x < maze->getWidth(); x++) {
+            int px = x * cellSize;
+            int py = y * cellSize;
+            Cell cell = maze->getCell(x, y);
+
+            if (cell.top)
+                drawWallLine(x, y, 0);
+            if (cell.left)
+                drawWallLine(x, y, 1);
+            if (cell.bottom && y == maze->getHeight() - 1)
+                addLine(px, py + cellSize, px + cellSize, py + cellSize, wallPen);
+            if (cell.right && x == maze->getWidth() - 1)
+                addLine(px + cellSize, py, px + cellSize, py + cellSize, wallPen);
         }
     }
 }
 
-void MazeScene::resetMaze() {
-    if (animationTimer->isActive()) {
-        animationTimer->stop();
+void MazeScene::drawWallLine(int x, int y, int side) {
+    int px = x * cellSize;
+    int py = y * cellSize;
+    QGraphicsLineItem*& line = wallLines[(static_cast<size_t>(y) * maze->getWidth() + x) * 2 + side];
+    if (line) return;
+    QPen wallPen(Qt::black, 2);
+    line = side == 0 ? addLine(px, py, px + cellSize, py, wallPen)
+                     : addLine(px, py, px, py + cellSize, wallPen);
+}
+
+bool MazeScene::toggleWall(int x, int y, int direction) {
+    if (isAnimating() || direction < 0 || direction > 3) return false;
+    static const int dx[4] = {0, 1, 0, -1};
+    static const int dy[4] = {-1, 0, 1, 0};
+    int nx = x + dx[direction], ny = y + dy[direction];
+    int w = maze->getWidth(), h = maze->getHeight();
+    if (x < 0 || x >= w || y < 0 || y >= h || nx < 0 || nx >= w || ny < 0 || ny >= h) {
+        return false;   // border walls stay
+    }
+    // The line is the top or left side of whichever cell is below or right
+    int lineX = std::max(x, nx), lineY = std::max(y, ny);
+    int side = dx[direction] != 0 ? 1 : 0;
+
+    TRACE_SCOPE("scene", "toggle wall");
+
+    // A drawn solution or replay no longer matches the maze
+    if (showingPath || replay) clearSolution();
+
+    bool present = maze->toggleWall(x, y, direction);
+    QGraphicsLineItem*& line = wallLines[(static_cast<size_t>(lineY) * maze->getWidth() + lineX) * 2 + side];
+    if (present) {
+        drawWallLine(lineX, lineY, side);
+    } else if (line) {
+        removeItem(line);
+        delete line;
+        line = nullptr;
     }
     
+    if (connectivity) connectivity->wallChanged(x, y, direction);
+    emit wallToggled(isGoalReachable());
+    return true;
+}
+
+bool MazeScene::isGoalReachable() {
+    if (!connectivity) connectivity = std::make_unique<DynamicConnectivity>(maze);
+    return connectivity->connected(0, 0, maze->getWidth() - 1, maze->getHeight() - 1);
+}
+
+void MazeScene::mousePressEvent(QGraphicsSceneMouseEvent* event) {
+    QPointF pos = event->scenePos();
+    int x = static_cast<int>(std::floor(pos.x() / cellSize));
+    int y = static_cast<int>(std::floor(pos.y() / cellSize));
+    if (event->button() != Qt::LeftButton || isAnimating() ||
+        x < 0 || x >= maze->getWidth() || y < 0 || y >= maze->getHeight()) {
+        QGraphicsScene::mousePressEvent(event);
+        return;
+    }
+
+    // Nearest side of the clicked cell, if the click is close enough to it
+    double fx = pos.x() - x * cellSize;
+    double fy = pos.y() - y * cellSize;
+    double distance[4] = {fy, cellSize - fx, cellSize - fy, fx};
+    int direction = static_cast<int>(std::min_element(distance, distance + 4) - distance);
+    if (distance[direction] > cellSize / 4.0 || !toggleWall(x, y, direction)) {
+        QGraphicsScene::mousePressEvent(event);
+        return;
+    }
+    event->accept();
+}
+
+void MazeScene::resetMaze() {
+    stopAnimation();
+    stopRace();
+    stopReplay();
+
     showingPath = false;
-    currentPath = PathResult();
+    currentPath.reset();
+    currentStats = SearchStats();
+    currentFromCache = false;
     pathStep = 0;
     
     maze->reset();
+    connectivity.reset();
     
-    clear();
     // Draw initial maze with all walls
-    for (int y = 0; y < maze->getHeight(); y++) {
-        for (int x = 0; x < maze->getWidth(); x++) {
-            drawCell(x, y, Qt::white);
-        }
-    }
+    drawMaze();
 }
 
 void MazeScene::clearSolution() {
-    if (animationTimer->isActive()) {
-        animationTimer->stop();
-    }
+    stopAnimation();
+    stopRace();
+    stopReplay();
     
     showingPath = false;
-    currentPath = PathResult();
+    currentPath.reset();
+    currentStats = SearchStats();
+    currentFromCache = false;
     pathStep = 0;
     
-    // Redraw maze with white cells only (no colored overlays)
-    for (int y = 0; y < maze->getHeight(); y++) {
-        for (int x = 0; x < maze->getWidth(); x++) {
-            drawCell(x, y, Qt::white);
-        }
+    // Recolor every cell white (no colored overlays)
+    for (QGraphicsRectItem* item : cellItems) {
+        item->setBrush(QBrush(Qt::white));
     }
 }
 
 void MazeScene::drawCell(int x, int y, const QColor& color) {
-    int px = x * cellSize;
-    int py = y * cellSize;
-    
-    // Draw cell rectangle
-    auto rect = addRect(px, py, cellSize, cellSize, QPen(Qt::black), QBrush(color));
-    
-    // Draw walls
-    Cell cell = maze->getCell(x, y);
-    int lineWidth = 2;
-    
-    if (cell.top)
-        addLine(px, py, px + cellSize, py, QPen(Qt::black, lineWidth));
-    if (cell.bottom)
-        addLine(px, py + cellSize, px + cellSize, py + cellSize, QPen(Qt::black, lineWidth));
-    if (cell.left)
-        addLine(px, py, px, py + cellSize, QPen(Qt::black, lineWidth));
-    if (cell.right)
-        addLine(px + cellSize, py, px + cellSize, py + cellSize, QPen(Qt::black, lineWidth));
-}
\ No newline at end of file
+    if (x < 0 || x >= maze->getWidth() || y < 0 || y >= maze->getHeight()) {
+        return;
+    }
+    cellItems[static_cast<size_t>(y) * maze->getWidth() + x]->setBrush(QBrush(color));
+}
@@ -2,25 +2,78 @@
 #define MAZESCENE_H
 
 #include <QGraphicsScene>
+#include <QGraphicsRectItem>
+#include <QGraphicsLineItem>
+#include <QElapsedTimer>
 #include <QTimer>
+#include <memory>
+#include <vector>
 #include "maze.h"
+#include "mazeconnectivity.h"
+#include "mazereplay.h"
 #include "pathfinder.h"
+#include "solutioncache.h"
+#include "solverrace.h"
 
 class MazeScene : public QGraphicsScene {
     Q_OBJECT
 
+public:
+    // Animation driver timing: one frame every FrameIntervalMs, and at most
+    // FrameBudgetNs of that frame spent advancing steps
+    static constexpr int FrameIntervalMs = 16;
+    static constexpr qint64 FrameBudgetNs = 8000000;
+
+    // Base rates at speed 1x (the original one-step-per-tick pacing)
+    static constexpr int GenerationStepsPerSecond = 100;
+    static constexpr int PathfindingStepsPerSecond = 20;
+
 private:
+    enum class AnimationMode { None, Generation, Pathfinding, Race, Replay };
+
     Maze* maze;
     int cellSize;
     int animationStep;
     int maxSteps;
     QTimer* animationTimer;
     
-    // Pathfinding visualization
-    PathResult currentPath;
+    // Frame-budgeted animation state
+    AnimationMode animationMode;
+    int speedMultiplier;        // 0 = as fast as the frame budget allows
+    double stepCredit;          // fractional steps carried between frames
+    QElapsedTimer frameClock;   // time since the previous frame
+    std::vector<QGraphicsRectItem*> cellItems;
+
+    // Pathfinding visualization. Results may be shared with the solution
+    // cache, so per-view numbers (render time) live in currentStats.
+    std::shared_ptr<const PathResult> currentPath;
+    SearchStats currentStats;
+    bool currentFromCache;
+    SolutionCache* solutionCache;   // not owned; nullptr solves every time
     int pathStep;
     bool showingPath;
-    QString solvingAlgorithm;  // "BFS" or "DFS"
+    QString solvingAlgorithm;  // registered algorithm name, e.g. "BFS"
+
+    // Race mode: all solvers at once, overlaid in per-algorithm colors
+    std::unique_ptr<SolverRace> race;
+    std::vector<long long> raceDrawn;       // explored cells drawn per lane
+    std::vector<unsigned int> raceVisits;   // per cell, bit i = lane i visited
+
+    // Replay playback over one timeline: wall removals, explored, path.
+    // replayPainted holds, per phase and cell, the step that first colored
+    // it (-1 = not yet), so a backward seek only revisits the steps undone.
+    std::shared_ptr<const MazeReplay> replay;
+    long long replayStep;
+    int replayPhase;
+    ReplayCursor replayCursor;
+    std::vector<long long> replayPainted;
+
+    // Wall editing. wallLines holds each cell's top (cell * 2) and left
+    // (cell * 2 + 1) wall line, nullptr where open, so a toggle touches one
+    // item. connectivity is built on the first edit and dropped whenever
+    // the maze is replaced wholesale.
+    std::vector<QGraphicsLineItem*> wallLines;
+    std::unique_ptr<DynamicConnectivity> connectivity;
     
 public:
     MazeScene(int w, int h, QObject* parent = nullptr);
@@ -32,16 +85,78 @@ public:
     void clearSolution();
     void resetMaze();
     
+    // Launch every registered solver in parallel and overlay their progress
+    void startRace();
+    const SolverRace* getRace() const { return race.get(); }
+    static QColor raceColor(int lane);
+
+    // Play a recorded generation and solve back without recomputing it.
+    // The replay must match the scene's maze size.
+    void playReplay(std::shared_ptr<const MazeReplay> recording);
+    void resumeReplay();                // continue from the current position
+    void seekReplay(long long step);    // jump to a timeline step, 0..length
+    bool hasReplay() const { return replay != nullptr; }
+    long long getReplayLength() const { return replay ? replay->totalSteps() : 0; }
+    long long getReplayPosition() const { return replayStep; }
+    // Saves the playing replay, or records the current maze and solution
+    bool saveReplay(const QString& filename, QString* error = nullptr) const;
+
+    // Flip an interior wall and redraw just that line. Returns false for
+    // border walls or while an animation runs. Emits wallToggled.
+    bool toggleWall(int x, int y, int direction);
+    // Whether the end corner is reachable from the start corner
+    bool isGoalReachable();
+
+    // Speed multiplier over the base rates; 0 runs unthrottled
+    void setAnimationSpeed(int multiplier);
+    int getAnimationSpeed() const { return speedMultiplier; }
+    bool isAnimating() const { return animationMode != AnimationMode::None; }
+
+    // Jump straight to the final state of the running animation
+    void skipAnimation();
+
     Maze* getMaze() { return maze; }
-    PathResult getCurrentPath() const { return currentPath; }
+    const PathResult& getCurrentPath() const;
+    const SearchStats& getCurrentStats() const { return currentStats; }
+    bool isCurrentPathCached() const { return currentFromCache; }
+    void setSolutionCache(SolutionCache* cache) { solutionCache = cache; }
+    const QString& getSolvingAlgorithm() const { return solvingAlgorithm; }
+
+signals:
+    void animationFinished();
+    void raceProgress();
+    void replayProgress();
+    void wallToggled(bool goalReachable);
+
+protected:
+    // A left click near a cell side toggles that wall
+    void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
 
 private slots:
-    void animateGeneration();
-    void animatePathfinding();
+    void onAnimationFrame();
     
 private:
+    void startAnimation(AnimationMode mode);
+    void stopAnimation();
+    bool animateGeneration();   // advance one step, false once done
+    bool animatePathfinding();  // advance one step, false once done
+    void solveWith(Algorithm algorithm);
+    void finishPathfinding();
+    bool animateRace();         // advance every lane one step, false once done
+    void finishRace();
+    void stopRace();
+    bool animateReplay();       // advance one timeline step, false once done
+    void stopReplay();
+    const ReplayTrack& replayTrack(int phase) const;
+    void positionReplayCursor();
+    void paintReplayStep(int phase, long long step, uint32_t value, std::vector<size_t>* touched);
+    QColor replayColor(size_t cell) const;
+    void redrawReplay();
+    double currentStepRate() const;
+
     void drawMaze();
+    void drawWallLine(int x, int y, int side);     // side 0 = top, 1 = left
     void drawCell(int x, int y, const QColor& color);
 };
 
-#endif // MAZESCENE_H
\ No newline at end of file
+#endif // MAZESCENE_H
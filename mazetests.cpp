@@ -0,0 +1,620 @@
+// Checks for mazecore: codec round trips and malformed input, and analyses
+// and solvers cross-checked against simple oracles. One ctest entry per
+// group: mazetests <group>.
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <unistd.h>
+#include "maze.h"
+#include "mazeanalytics.h"
+#include "mazearchive.h"
+#include "mazeconnectivity.h"
+#include "mazeio.h"
+#include "mazereplay.h"
+#include "mazetext.h"
+#include "mazevalidator.h"
+#include "memorytracker.h"
+#include "pathfinder.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                         \
+    do {                                                                         \
+        if (!(condition)) {                                                      \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " #condition "\n";   \
+            failures++;                                                          \
+        }                                                                        \
+    } while (0)
+
+// Scratch file removed at the end of the scope
+class TempFile {
+private:
+    std::string name;
+
+public:
+    explicit TempFile(const std::string& suffix) {
+        static int counter = 0;
+        name = (std::filesystem::temp_directory_path() /
+                ("mazetests-" + std::to_string(::getpid()) + "-" + std::to_string(counter++) + suffix)).string();
+    }
+    ~TempFile() { std::remove(name.c_str()); }
+
+    const std::string& path() const { return name; }
+
+    std::string read() const {
+        std::ifstream in(name, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    void write(const std::string& bytes) const {
+        std::ofstream out(name, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+};
+
+std::string u32(uint32_t value) {
+    std::string bytes(4, '\0');
+    for (int i = 0; i < 4; i++) bytes[i] = static_cast<char>(value >> (8 * i));
+    return bytes;
+}
+
+bool sameWalls(const Maze& a, const Maze& b) {
+    if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight()) return false;
+    size_t cells = static_cast<size_t>(a.getWidth()) * a.getHeight();
+    return std::equal(a.wallMasks(), a.wallMasks() + cells, b.wallMasks()) && a.fingerprint() == b.fingerprint();
+}
+
+std::unique_ptr<Maze> randomMaze(std::mt19937& rng) {
+    int width = 1 + static_cast<int>(rng() % 40), height = 1 + static_cast<int>(rng() % 40);
+    auto maze = std::make_unique<Maze>(width, height);
+    maze->generateMaze(static_cast<int>(rng() % 50), static_cast<unsigned int>(rng()));
+    return maze;
+}
+
+// Every prefix of a valid file must load as an error, never crash or throw
+template <typename Load>
+void checkTruncations(const TempFile& file, Load load) {
+    std::string whole = file.read();
+    for (size_t length = 0; length < whole.size(); length++) {
+        file.write(whole.substr(0, length));
+        std::string error;
+        CHECK(!load(file.path(), &error));
+        CHECK(!error.empty());
+    }
+    file.write(whole);
+}
+
+void testSolverStats() {
+    std::mt19937 rng(9);
+    static const int dx[4] = {0, 1, 0, -1}, dy[4] = {-1, 0, 1, 0};
+    for (int i = 0; i < 30; i++) {
+        std::unique_ptr<Maze> maze = randomMaze(rng);
+        PathFinder pf(maze.get(), 0, 0, maze->getWidth() - 1, maze->getHeight() - 1);
+        for (Algorithm algorithm : {Algorithm::BFS, Algorithm::DFS, Algorithm::Dijkstra}) {
+            PathResult result = pf.solve(algorithm);
+            CHECK(result.found);
+            CHECK(result.stats.setupNs > 0 && result.stats.searchNs > 0);
+            CHECK(result.stats.nodesExpanded == result.stepsCount);
+
+            // BFS expands cells in the order it explores them; every expansion
+            // but the last (the end) examines each open neighbour once
+            if (algorithm != Algorithm::BFS) continue;
+            long long open = 0;
+            for (long long n = 0; n + 1 < result.stats.nodesExpanded; n++) {
+                auto [x, y] = result.explored[n];
+                for (int d = 0; d < 4; d++) {
+                    int nx = x + dx[d], ny = y + dy[d];
+                    open += nx >= 0 && ny >= 0 && nx < maze->getWidth() && ny < maze->getHeight() &&
+                            !maze->hasWall(x, y, d);
+                }
+            }
+            CHECK(result.stats.neighborChecks == open);
+        }
+    }
+}
+
+void testMazeFile() {
+    std::mt19937 rng(1);
+    TempFile file(".maze");
+    for (int i = 0; i < 50; i++) {
+        std::unique_ptr<Maze> maze = randomMaze(rng);
+        CHECK(saveMaze(*maze, file.path()));
+        std::unique_ptr<Maze> loaded = loadMaze(file.path());
+        CHECK(loaded && sameWalls(*maze, *loaded));
+    }
+    checkTruncations(file, [](const std::string& path, std::string* error) { return loadMaze(path, error) != nullptr; });
+
+    // Headers claiming more cells than fit, or than the file holds
+    std::string header = std::string("MAZE") + u32(1);
+    for (auto [width, height] : {std::pair<uint32_t, uint32_t>{0x7fffffff, 0x7fffffff}, {65536, 65536},
+                                 {40000, 40000}, {0, 5}, {0x80000000u, 1}}) {
+        file.write(header + u32(width) + u32(height) + std::string(16, '\0'));
+        std::string error;
+        CHECK(!loadMaze(file.path(), &error));
+        CHECK(!error.empty());
+    }
+    file.write("MAZX" + u32(1) + u32(1) + u32(1) + std::string(1, '\0'));
+    CHECK(!loadMaze(file.path()));
+}
+
+// Bytes currently held by each subsystem a Maze allocates from
+std::vector<long long> mazeBytes() {
+    std::vector<long long> bytes;
+    for (MemorySubsystem s : {MemorySubsystem::MazeGrid, MemorySubsystem::WallRemovalOrder, MemorySubsystem::MazeWeights}) {
+        bytes.push_back(MemoryTracker::stats(s).currentBytes);
+    }
+    return bytes;
+}
+
+void testMemory() {
+    Maze maze(100, 80);
+    maze.generateMaze(5, 1u);
+    maze.fillRandomWeights(300, 2);
+    maze.setCellLayout(CellLayoutKind::Morton);
+    std::vector<long long> before = mazeBytes();
+
+    // Copies are charged to the same subsystems as the original
+    {
+        Maze copy(maze);
+        std::vector<long long> after = mazeBytes();
+        for (size_t s = 0; s < before.size(); s++) CHECK(after[s] > before[s]);
+        CHECK(sameWalls(copy, maze));
+        CHECK(copy.getWeight(7, 9) == maze.getWeight(7, 9));
+
+        Maze assigned(3, 3);
+        assigned = maze;
+        std::vector<long long> twice = mazeBytes();
+        for (size_t s = 0; s < before.size(); s++) CHECK(twice[s] > after[s]);
+        CHECK(sameWalls(assigned, maze));
+        CHECK(assigned.getWallRemovalOrder().size() == maze.getWallRemovalOrder().size());
+    }
+    CHECK(mazeBytes() == before);
+}
+
+void testArchive() {
+    std::mt19937 rng(2);
+    TempFile scratch("");   // only its name is used, as the shard prefix
+    std::string name = MazeArchiveWriter::shardName(scratch.path(), 0);
+
+    std::vector<std::unique_ptr<Maze>> mazes;
+    std::vector<PathResult> solutions;
+    {
+        MazeArchiveWriter writer(scratch.path(), 1000);
+        for (int i = 0; i < 30; i++) {
+            mazes.push_back(randomMaze(rng));
+            const Maze& maze = *mazes.back();
+            PathFinder pf(&maze, 0, 0, maze.getWidth() - 1, maze.getHeight() - 1);
+            solutions.push_back(pf.solveBFS());
+            std::string record;
+            encodeArchiveRecord(record, static_cast<uint64_t>(i), maze, 0, i % 2 ? &solutions.back() : nullptr);
+            CHECK(writer.append(record.data(), record.size()));
+        }
+        CHECK(writer.close());
+    }
+
+    size_t seen = 0;
+    CHECK(readArchiveShard(name, [&](ArchiveRecord& record) {
+        CHECK(record.index == seen);
+        CHECK(sameWalls(*record.maze, *mazes[seen]));
+        CHECK(record.solved == (seen % 2 == 1));
+        if (record.solved) {
+            const auto& expected = solutions[seen].path;
+            CHECK(std::equal(record.path.begin(), record.path.end(), expected.begin(), expected.end()));
+        }
+        seen++;
+        return true;
+    }));
+    CHECK(seen == mazes.size());
+
+    // Malformed shards: cut short, oversized maze, path leaving the maze
+    std::ifstream in(name, std::ios::binary);
+    std::string whole((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    auto rejects = [&](const std::string& bytes) {
+        std::ofstream(name, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size());
+        std::string error;
+        bool ok = readArchiveShard(name, [](ArchiveRecord&) { return true; }, &error);
+        return !ok && !error.empty();
+    };
+    CHECK(rejects(whole.substr(0, whole.size() - 1)));
+    CHECK(rejects(whole.substr(0, 20)));
+    std::string huge = whole;
+    huge.replace(12 + 12, 8, u32(0xffff) + u32(0xffff));
+    CHECK(rejects(huge));
+    // One solved 2x1 record whose start sits outside the maze
+    std::string bigStart = whole.substr(0, 12);
+    bigStart += std::string(8, '\0') + u32(0) + u32(2) + u32(1) + u32(0) + std::string(1, '\3') +
+                u32(7) + u32(0) + u32(2) + std::string(1, '\0') + std::string(1, '\0');
+    CHECK(rejects(bigStart));
+    // Start (1, 0) of a 2x1 maze, then one move right (code 1)
+    std::string walksOut = whole.substr(0, 12);
+    walksOut += std::string(8, '\0') + u32(0) + u32(2) + u32(1) + u32(0) + std::string(1, '\3') +
+                u32(1) + u32(0) + u32(2) + std::string(1, '\0') + std::string(1, '\1');
+    CHECK(rejects(walksOut));
+    std::remove(name.c_str());
+}
+
+// Whether the wall between (x, y) and its neighbour in direction is open on
+// both sides; the border is never open
+bool passage(const Maze& maze, int x, int y, int direction) {
+    static const int dx[4] = {0, 1, 0, -1}, dy[4] = {-1, 0, 1, 0};
+    int nx = x + dx[direction], ny = y + dy[direction];
+    if (nx < 0 || ny < 0 || nx >= maze.getWidth() || ny >= maze.getHeight()) return false;
+    return !maze.hasWall(x, y, direction) && !maze.hasWall(nx, ny, (direction + 2) % 4);
+}
+
+// The metrics that have a plain definition, counted cell by cell
+MazeMetrics bruteForceMetrics(const Maze& maze) {
+    static const int dx[4] = {0, 1, 0, -1}, dy[4] = {-1, 0, 1, 0};
+    int width = maze.getWidth(), height = maze.getHeight();
+    MazeMetrics metrics;
+    metrics.cells = static_cast<long long>(width) * height;
+
+    std::vector<int> horizontal(metrics.cells, 1), vertical(metrics.cells, 1);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int degree = 0;
+            for (int d = 0; d < 4; d++) degree += passage(maze, x, y, d);
+            metrics.degreeHistogram[degree]++;
+            metrics.passages += passage(maze, x, y, 1) + passage(maze, x, y, 2);
+
+            int cell = y * width + x;
+            if (passage(maze, x, y, 3)) horizontal[cell] = horizontal[cell - 1] + 1;
+            if (passage(maze, x, y, 0)) vertical[cell] = vertical[cell - width] + 1;
+            metrics.longestCorridor = std::max({metrics.longestCorridor, horizontal[cell], vertical[cell]});
+        }
+    }
+    metrics.deadEnds = metrics.degreeHistogram[1];
+    metrics.junctions = metrics.degreeHistogram[3] + metrics.degreeHistogram[4];
+
+    // Components by flood fill; the first one holds the start corner
+    std::vector<int> dist(metrics.cells, -1);
+    for (int source = 0; source < metrics.cells; source++) {
+        if (dist[source] >= 0) continue;
+        metrics.components++;
+        std::vector<int> queue = {source};
+        dist[source] = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            int cell = queue[head], x = cell % width, y = cell / width;
+            for (int d = 0; d < 4; d++) {
+                int next = (y + dy[d]) * width + x + dx[d];
+                if (passage(maze, x, y, d) && dist[next] < 0) {
+                    dist[next] = dist[cell] + 1;
+                    queue.push_back(next);
+                }
+            }
+        }
+        if (source == 0 && dist[metrics.cells - 1] >= 0) {
+            metrics.solvable = true;
+            metrics.solutionLength = dist[metrics.cells - 1] + 1;
+        }
+    }
+    metrics.cycles = metrics.passages - metrics.cells + metrics.components;
+    return metrics;
+}
+
+bool sameCounts(const MazeMetrics& a, const MazeMetrics& b) {
+    return a.cells == b.cells && a.passages == b.passages &&
+           std::equal(a.degreeHistogram, a.degreeHistogram + 5, b.degreeHistogram) &&
+           a.deadEnds == b.deadEnds && a.junctions == b.junctions && a.longestCorridor == b.longestCorridor &&
+           a.components == b.components && a.cycles == b.cycles && a.solvable == b.solvable &&
+           a.solutionLength == b.solutionLength;
+}
+
+void testAnalytics() {
+    std::mt19937 rng(7);
+    for (int i = 0; i < 60; i++) {
+        std::unique_ptr<Maze> maze = randomMaze(rng);
+
+        // Every third maze gets one-sided openings, which must connect nothing
+        if (i % 3 == 0) {
+            maze->rewriteWallMasks([&](uint8_t* masks) {
+                size_t cells = static_cast<size_t>(maze->getWidth()) * maze->getHeight();
+                for (size_t n = 0; n < cells / 4 + 1; n++) masks[rng() % cells] ^= static_cast<uint8_t>(1 << (rng() % 4));
+            });
+        }
+
+        MazeMetrics expected = bruteForceMetrics(*maze);
+        MazeMetrics metrics = analyzeMaze(*maze);
+        CHECK(sameCounts(metrics, expected));
+        for (int threads : {2, 5}) {
+            MazeMetrics striped = analyzeMaze(*maze, threads);
+            CHECK(sameCounts(striped, metrics));
+            CHECK(striped.solutionTurns == metrics.solutionTurns);
+            CHECK(striped.diameterEstimate == metrics.diameterEstimate);
+        }
+    }
+
+    // 2x1 and 1x2 mazes where only one copy of the shared wall is open
+    for (auto [width, height, first, second] : {std::tuple<int, int, uint8_t, uint8_t>{2, 1, 13, 15}, {2, 1, 15, 7},
+                                                {1, 2, 11, 15}, {1, 2, 15, 14}}) {
+        Maze maze(width, height);
+        maze.rewriteWallMasks([&](uint8_t* masks) {
+            masks[0] = first;
+            masks[1] = second;
+        });
+        MazeMetrics metrics = analyzeMaze(maze);
+        CHECK(!metrics.solvable);
+        CHECK(metrics.passages == 0 && metrics.components == 2 && metrics.degreeHistogram[0] == 2);
+        CHECK(sameCounts(metrics, bruteForceMetrics(maze)));
+    }
+}
+
+void testDijkstra() {
+    std::mt19937 rng(5);
+    for (int i = 0; i < 40; i++) {
+        std::unique_ptr<Maze> maze = randomMaze(rng);
+        int endX = maze->getWidth() - 1, endY = maze->getHeight() - 1;
+        PathFinder pf(maze.get(), 0, 0, endX, endY);
+
+        // Unweighted: every solver that finds shortest paths agrees with BFS
+        PathResult bfs = pf.solveBFS();
+        CHECK(pf.solveDijkstra(PriorityQueueKind::Radix).totalCost == bfs.totalCost);
+        CHECK(pf.solveDijkstra(PriorityQueueKind::Binary).totalCost == bfs.totalCost);
+
+        maze->fillRandomWeights(i % 2 ? 9 : 300, static_cast<unsigned int>(rng()));
+        PathResult radix = pf.solveDijkstra(PriorityQueueKind::Radix);
+        PathResult binary = pf.solveDijkstra(PriorityQueueKind::Binary);
+        CHECK(radix.found && binary.found);
+        CHECK(radix.totalCost == binary.totalCost);
+        CHECK(radix.path.front() == std::make_pair(0, 0) && radix.path.back() == std::make_pair(endX, endY));
+        CHECK(radix.stats.bytesAllocated > 0 && binary.stats.bytesAllocated > 0);
+
+        // The path's cost is what it claims
+        long long cost = 0;
+        for (size_t p = 1; p < radix.path.size(); p++) cost += maze->getWeight(radix.path[p].first, radix.path[p].second);
+        CHECK(cost == radix.totalCost);
+    }
+}
+
+void testReplay() {
+    std::mt19937 rng(3);
+    TempFile file(".mzrp");
+    for (int i = 0; i < 30; i++) {
+        std::unique_ptr<Maze> maze = randomMaze(rng);
+        MazeReplay replay = recordReplay(*maze);
+        PathFinder pf(maze.get(), 0, 0, maze->getWidth() - 1, maze->getHeight() - 1);
+        PathResult result = pf.solveDFS();
+        if (i % 2) replay.recordSolve(result, "DFS", 0, 0, maze->getWidth() - 1, maze->getHeight() - 1);
+        CHECK(saveReplay(replay, file.path()));
+
+        std::unique_ptr<MazeReplay> loaded = loadReplay(file.path());
+        CHECK(loaded != nullptr);
+        if (!loaded) continue;
+        CHECK(sameWalls(*loaded->buildMaze(), *maze));
+        CHECK(loaded->hasSolve() == (i % 2 == 1));
+        CHECK(loaded->totalSteps() == replay.totalSteps());
+    }
+
+    // Edited mazes are not the sum of their removals; their walls are stored outright
+    for (int i = 0; i < 10; i++) {
+        std::unique_ptr<Maze> maze = randomMaze(rng);
+        maze->rewriteWallMasks([&](uint8_t* masks) {
+            masks[rng() % (static_cast<size_t>(maze->getWidth()) * maze->getHeight())] ^= 1 << (rng() % 4);
+        });
+        CHECK(saveReplay(recordReplay(*maze), file.path()));
+        std::unique_ptr<MazeReplay> loaded = loadReplay(file.path());
+        CHECK(loaded && sameWalls(*loaded->buildMaze(), *maze));
+    }
+    checkTruncations(file, [](const std::string& path, std::string* error) { return loadReplay(path, error) != nullptr; });
+
+    file.write("MZRP" + u32(1) + u32(0x10000) + u32(0x10000) + std::string(64, '\0'));
+    CHECK(!loadReplay(file.path()));
+}
+
+void testValidator() {
+    std::mt19937 rng(8);
+
+    // Generated mazes are symmetric and connected, with the loops asked for
+    for (int cycles : {0, 1, 7, 40}) {
+        Maze maze(30, 20);
+        maze.generateMaze(cycles, static_cast<unsigned int>(rng()));
+        for (int threads : {1, 3, 0}) {
+            MazeValidation report = validateMaze(maze, threads);
+            CHECK(report.symmetric() && report.connected());
+            CHECK(report.cycleRank == cycles);
+            CHECK(report.perfect() == (cycles == 0));
+            CHECK(report.unreachableCells == 0 && report.unreachable.empty());
+        }
+    }
+
+    // Damaged mazes: flipped single wall copies, including border walls
+    static const int dx[4] = {0, 1, 0, -1}, dy[4] = {-1, 0, 1, 0};
+    for (int i = 0; i < 60; i++) {
+        std::unique_ptr<Maze> maze = randomMaze(rng);
+        int width = maze->getWidth(), height = maze->getHeight();
+        maze->rewriteWallMasks([&](uint8_t* masks) {
+            size_t cells = static_cast<size_t>(width) * height;
+            for (size_t n = 0; n < cells / 8 + 1; n++) masks[rng() % cells] ^= static_cast<uint8_t>(1 << (rng() % 4));
+        });
+
+        long long mismatched = 0, openBorder = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                for (int d = 0; d < 4; d++) {
+                    int nx = x + dx[d], ny = y + dy[d];
+                    bool inside = nx >= 0 && ny >= 0 && nx < width && ny < height;
+                    if (!inside) openBorder += !maze->hasWall(x, y, d);
+                    else if (d == 1 || d == 2) mismatched += maze->hasWall(x, y, d) != maze->hasWall(nx, ny, (d + 2) % 4);
+                }
+            }
+        }
+        MazeMetrics expected = bruteForceMetrics(*maze);
+
+        for (int threads : {1, 4}) {
+            MazeValidation report = validateMaze(*maze, threads);
+            CHECK(report.cells == expected.cells);
+            CHECK(report.passages == expected.passages);
+            CHECK(report.components == expected.components);
+            CHECK(report.cycleRank == expected.cycles);
+            CHECK(report.mismatchedWalls == mismatched);
+            CHECK(report.openBorderWalls == openBorder);
+            CHECK(report.mismatches.size() == std::min<size_t>(mismatched, MazeValidation::MaxListed));
+            for (const WallMismatch& m : report.mismatches) {
+                CHECK(maze->hasWall(m.x, m.y, m.direction) !=
+                      maze->hasWall(m.x + dx[m.direction], m.y + dy[m.direction], (m.direction + 2) % 4));
+            }
+            long long listed = 0;
+            for (const UnreachableRegion& region : report.unreachable) listed += region.cells;
+            CHECK(report.unreachable.size() == std::min<size_t>(expected.components - 1, MazeValidation::MaxListed));
+            CHECK(report.unreachable.size() < MazeValidation::MaxListed ? listed == report.unreachableCells
+                                                                         : listed <= report.unreachableCells);
+        }
+    }
+
+    // One walled-off cell is its own unreachable region
+    Maze maze(6, 5);
+    maze.generateMaze(10, 99);
+    for (int d = 0; d < 4; d++) maze.setWall(3, 2, d, true);
+    MazeValidation report = validateMaze(maze);
+    CHECK(report.symmetric() && !report.connected() && !report.perfect());
+    CHECK(!report.unreachable.empty());
+    bool found = false;
+    for (const UnreachableRegion& region : report.unreachable) found |= region.x == 3 && region.y == 2 && region.cells == 1;
+    CHECK(found);
+}
+
+// Plain BFS over cells joined by walls open on both sides
+bool reachable(const Maze& maze, int ax, int ay, int bx, int by) {
+    int width = maze.getWidth(), height = maze.getHeight();
+    static const int dx[4] = {0, 1, 0, -1}, dy[4] = {-1, 0, 1, 0};
+    std::vector<char> seen(static_cast<size_t>(width) * height, 0);
+    std::queue<std::pair<int, int>> queue;
+    queue.push({ax, ay});
+    seen[ay * width + ax] = 1;
+    while (!queue.empty()) {
+        auto [x, y] = queue.front();
+        queue.pop();
+        if (x == bx && y == by) return true;
+        for (int d = 0; d < 4; d++) {
+            int nx = x + dx[d], ny = y + dy[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            if (maze.hasWall(x, y, d) || maze.hasWall(nx, ny, (d + 2) % 4)) continue;
+            if (!seen[ny * width + nx]) {
+                seen[ny * width + nx] = 1;
+                queue.push({nx, ny});
+            }
+        }
+    }
+    return false;
+}
+
+void testConnectivity() {
+    std::mt19937 rng(6);
+    for (int round = 0; round < 20; round++) {
+        std::unique_ptr<Maze> maze = randomMaze(rng);
+        int width = maze->getWidth(), height = maze->getHeight();
+        Maze start(width, height);
+        start.rewriteWallMasks([&](uint8_t* masks) {
+            std::copy(maze->wallMasks(), maze->wallMasks() + static_cast<size_t>(width) * height, masks);
+        });
+
+        std::vector<ConnectivityOp> ops;
+        std::vector<bool> oracle, online;
+        DynamicConnectivity live(maze.get(), 1 + round % 4);
+        for (int i = 0; i < 300; i++) {
+            ConnectivityOp op;
+            op.x = static_cast<int>(rng() % width);
+            op.y = static_cast<int>(rng() % height);
+            switch (rng() % 4) {
+                case 0: op.kind = ConnectivityOp::Kind::Open; break;
+                case 1: op.kind = ConnectivityOp::Kind::Close; break;
+                case 2: op.kind = ConnectivityOp::Kind::Toggle; break;
+                default: op.kind = ConnectivityOp::Kind::Query; break;
+            }
+            op.direction = static_cast<int>(rng() % 4);
+            op.x2 = static_cast<int>(rng() % width);
+            op.y2 = static_cast<int>(rng() % height);
+            ops.push_back(op);
+
+            if (op.kind == ConnectivityOp::Kind::Query) {
+                oracle.push_back(reachable(*maze, op.x, op.y, op.x2, op.y2));
+                online.push_back(live.connected(op.x, op.y, op.x2, op.y2));
+                continue;
+            }
+            switch (op.kind) {
+                case ConnectivityOp::Kind::Open: maze->setWall(op.x, op.y, op.direction, false); break;
+                case ConnectivityOp::Kind::Close: maze->setWall(op.x, op.y, op.direction, true); break;
+                default: maze->toggleWall(op.x, op.y, op.direction); break;
+            }
+            live.wallChanged(op.x, op.y, op.direction);
+        }
+
+        std::vector<bool> offline = solveConnectivityOffline(start, ops);
+        CHECK(offline == oracle);
+        CHECK(online == oracle);
+    }
+}
+
+void testText() {
+    std::mt19937 rng(4);
+    TempFile file(".txt");
+    for (int i = 0; i < 50; i++) {
+        std::unique_ptr<Maze> maze = randomMaze(rng);
+        TextMazeStyle style = i % 2 ? TextMazeStyle::Lines : TextMazeStyle::Blocks;
+        CHECK(saveTextMaze(*maze, file.path(), style));
+        for (int threads : {1, 3}) {
+            std::unique_ptr<Maze> loaded = loadTextMaze(file.path(), nullptr, threads);
+            CHECK(loaded && sameWalls(*maze, *loaded));
+        }
+
+        // CRLF line endings and trailing blank lines load the same
+        std::string text = formatTextMaze(*maze, style), crlf;
+        for (char c : text) crlf += c == '\n' ? std::string("\r\n") : std::string(1, c);
+        crlf += "\r\n\n";
+        std::unique_ptr<Maze> loaded = parseTextMaze(crlf.data(), crlf.size());
+        CHECK(loaded && sameWalls(*maze, *loaded));
+    }
+
+    // A wider "+---+" drawing of a 2x1 maze with one open wall
+    std::string wide = "+---+---+\n|       |\n+---+---+\n";
+    std::unique_ptr<Maze> two = parseTextMaze(wide.data(), wide.size());
+    CHECK(two && two->getWidth() == 2 && two->getHeight() == 1 && !two->hasWall(0, 0, 1));
+
+    for (std::string bad : {std::string(""), std::string("###\n# #\n"), std::string("\n###\n# #\n###\n"),
+                            std::string("+--\n|  \n+--\n"), std::string("#\n#\n#\n")}) {
+        std::string error;
+        CHECK(!parseTextMaze(bad.data(), bad.size(), &error));
+        CHECK(!error.empty());
+    }
+    std::string error;
+    CHECK(!loadTextMaze(file.path() + ".missing", &error));
+    CHECK(!error.empty());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::map<std::string, std::function<void()>> groups = {
+        {"solver-stats", testSolverStats},
+        {"maze-file", testMazeFile},
+        {"memory", testMemory},
+        {"archive", testArchive},
+        {"analytics", testAnalytics},
+        {"dijkstra", testDijkstra},
+        {"replay", testReplay},
+        {"validator", testValidator},
+        {"connectivity", testConnectivity},
+        {"text", testText},
+    };
+
+    if (argc != 2 || !groups.count(argv[1])) {
+        std::cerr << "Usage: mazetests <group>\nGroups:";
+        for (const auto& group : groups) std::cerr << " " << group.first;
+        std::cerr << "\n";
+        return 2;
+    }
+    groups.at(argv[1])();
+    if (failures) std::cerr << failures << " check(s) failed\n";
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,325 @@
+#include "mazetext.h"
+#include "mazeutil.h"
+#include "tracer.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MAZETEXT_SSE2 1
+#endif
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Read-only view of a whole file: mapped where the platform allows it,
+// read into memory otherwise
+class MappedFile {
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+    std::vector<char> buffer;
+#if !defined(_WIN32)
+    void* mapping = nullptr;
+#endif
+
+public:
+    bool open(const std::string& filename, std::string* error) {
+#if !defined(_WIN32)
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            setError(error, "cannot open " + filename);
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            setError(error, "cannot stat " + filename);
+            return false;
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                mapping = nullptr;
+                ::close(fd);
+                setError(error, "cannot map " + filename);
+                return false;
+            }
+            // Rows are parsed in parallel all over the file, not front to back
+            madvise(mapping, length, MADV_WILLNEED);
+            bytes = static_cast<const char*>(mapping);
+        }
+        ::close(fd);
+        return true;
+#else
+        std::ifstream in(filename, std::ios::binary);
+        if (!in) {
+            setError(error, "cannot open " + filename);
+            return false;
+        }
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        bytes = buffer.data();
+        length = buffer.size();
+        return true;
+#endif
+    }
+
+    ~MappedFile() {
+#if !defined(_WIN32)
+        if (mapping) munmap(mapping, length);
+#endif
+    }
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+// Offsets of every '\n' in [first, last)
+void findNewlines(const char* text, size_t first, size_t last, std::vector<size_t>& out) {
+    size_t i = first;
+#if defined(MAZETEXT_SSE2)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= last; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        unsigned int hits = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+        for (; hits; hits &= hits - 1) {
+            int lane = 0;
+            while (!((hits >> lane) & 1)) lane++;
+            out.push_back(i + lane);
+        }
+    }
+#endif
+    for (; i < last; i++) {
+        if (text[i] == '\n') out.push_back(i);
+    }
+}
+
+// Sets bit c of bits for every column c < columns whose byte is not a
+// space; bits must hold columns bits and is cleared first
+void classifyLine(const char* line, size_t length, size_t columns, std::vector<uint64_t>& bits) {
+    std::fill(bits.begin(), bits.end(), 0);
+    length = std::min(length, columns);
+    size_t i = 0;
+#if defined(MAZETEXT_SSE2)
+    const __m128i space = _mm_set1_epi8(' ');
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + i));
+        uint64_t walls = ~static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, space))) & 0xffffu;
+        bits[i / 64] |= walls << (i % 64);   // 16 divides 64, so never straddles
+    }
+#endif
+    for (; i < length; i++) {
+        if (line[i] != ' ') bits[i / 64] |= 1ULL << (i % 64);
+    }
+}
+
+inline uint8_t bitAt(const std::vector<uint64_t>& bits, size_t column) {
+    return static_cast<uint8_t>((bits[column / 64] >> (column % 64)) & 1);
+}
+
+// The text split into lines, without \r\n and trailing blank lines
+struct LineIndex {
+    const char* text;
+    size_t size;
+    std::vector<size_t> newlines;
+    size_t count = 0;
+
+    void line(size_t i, const char*& begin, size_t& length) const {
+        size_t first = i == 0 ? 0 : newlines[i - 1] + 1;
+        size_t last = i < newlines.size() ? newlines[i] : size;
+        if (last > first && text[last - 1] == '\r') last--;
+        begin = text + first;
+        length = last - first;
+    }
+};
+
+void indexLines(const char* text, size_t size, int stripeCount, LineIndex& index) {
+    TRACE_SCOPE("mazetext", "index lines");
+    index.text = text;
+    index.size = size;
+    std::vector<std::vector<size_t>> found(stripeCount);
+    forEachStripe(stripeCount, size, [&](int s, size_t first, size_t last) {
+        found[s].reserve((last - first) / 64);
+        findNewlines(text, first, last, found[s]);
+    });
+    for (const std::vector<size_t>& part : found) {
+        index.newlines.insert(index.newlines.end(), part.begin(), part.end());
+    }
+
+    index.count = index.newlines.size() + 1;
+    while (index.count > 0) {
+        const char* begin;
+        size_t length;
+        index.line(index.count - 1, begin, length);
+        if (length > 0) break;
+        index.count--;
+    }
+}
+
+void appendLine(std::string& out, TextMazeStyle style, const uint8_t* masks, int width, int height, int line) {
+    bool blocks = style == TextMazeStyle::Blocks;
+    size_t stride = blocks ? 2 : 3;
+    size_t start = out.size();
+    out.resize(start + static_cast<size_t>(width) * stride + 2, ' ');
+    char* text = &out[start];
+    if (line % 2 == 0) {
+        // Corners and the horizontal walls above row line / 2
+        int y = line / 2;
+        for (int x = 0; x < width; x++) {
+            bool wall;
+            if (y == 0) wall = masks[x] & WallTop;
+            else if (y == height) wall = masks[static_cast<size_t>(height - 1) * width + x] & WallBottom;
+            else wall = (masks[static_cast<size_t>(y - 1) * width + x] & WallBottom) ||
+                        (masks[static_cast<size_t>(y) * width + x] & WallTop);
+            text[x * stride] = blocks ? '#' : '+';
+            if (wall) std::fill(text + x * stride + 1, text + (x + 1) * stride, blocks ? '#' : '-');
+        }
+        text[width * stride] = blocks ? '#' : '+';
+    } else {
+        // Vertical walls of row line / 2; the interiors stay spaces
+        const uint8_t* row = masks + static_cast<size_t>(line / 2) * width;
+        for (int x = 0; x <= width; x++) {
+            bool wall;
+            if (x == 0) wall = row[0] & WallLeft;
+            else if (x == width) wall = row[width - 1] & WallRight;
+            else wall = (row[x - 1] & WallRight) || (row[x] & WallLeft);
+            if (wall) text[x * stride] = blocks ? '#' : '|';
+        }
+    }
+    text[width * stride + 1] = '\n';
+}
+
+} // namespace
+
+bool isTextMazePath(const std::string& filename) {
+    return filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".txt") == 0;
+}
+
+bool saveTextMaze(const Maze& maze, const std::string& filename, TextMazeStyle style, std::string* error) {
+    TRACE_SCOPE("mazetext", "saveTextMaze");
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        setError(error, "cannot open " + filename + " for writing");
+        return false;
+    }
+
+    // Flush in chunks of about 1 MB so memory stays flat on huge mazes
+    std::string chunk;
+    int lines = 2 * maze.getHeight() + 1;
+    for (int line = 0; line < lines; line++) {
+        appendLine(chunk, style, maze.wallMasks(), maze.getWidth(), maze.getHeight(), line);
+        if (chunk.size() >= (1 << 20) || line + 1 == lines) {
+            out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            chunk.clear();
+        }
+    }
+
+    if (!out) {
+        setError(error, "failed writing " + filename);
+        return false;
+    }
+    return true;
+}
+
+std::string formatTextMaze(const Maze& maze, TextMazeStyle style) {
+    std::string text;
+    int lines = 2 * maze.getHeight() + 1;
+    text.reserve(static_cast<size_t>(lines) * (static_cast<size_t>(maze.getWidth()) * 3 + 2));
+    for (int line = 0; line < lines; line++) {
+        appendLine(text, style, maze.wallMasks(), maze.getWidth(), maze.getHeight(), line);
+    }
+    return text;
+}
+
+std::unique_ptr<Maze> parseTextMaze(const char* text, size_t size, std::string* error, int threads) {
+    TRACE_SCOPE("mazetext", "parseTextMaze");
+    threads = resolveThreads(threads);
+
+    LineIndex index;
+    // Small inputs are not worth a thread each
+    int scanStripes = static_cast<int>(std::clamp<size_t>(static_cast<size_t>(threads), 1,
+                                                          std::max<size_t>(size / (1 << 20), 1)));
+    indexLines(text, size, scanStripes, index);
+    if (index.count < 3 || index.count % 2 == 0) {
+        setError(error, "text maze needs an odd number of lines, at least 3");
+        return nullptr;
+    }
+
+    // Style and cell stride from the first line
+    const char* first;
+    size_t firstLength;
+    index.line(0, first, firstLength);
+    size_t stride = 2;
+    if (firstLength == 0) {
+        setError(error, "text maze starts with a blank line");
+        return nullptr;
+    }
+    if (first[0] == '+') {
+        const char* next = std::find(first + 1, first + firstLength, '+');
+        stride = static_cast<size_t>(next - first);
+        if (next == first + firstLength || stride < 2) {
+            setError(error, "cannot find the second '+' corner on the first line");
+            return nullptr;
+        }
+    }
+    long long width = static_cast<long long>((firstLength - 1) / stride);
+    long long height = static_cast<long long>((index.count - 1) / 2);
+    if (firstLength < 1 + stride || width * height > INT_MAX) {
+        setError(error, "text maze is too narrow or too large");
+        return nullptr;
+    }
+
+    auto maze = std::make_unique<Maze>(static_cast<int>(width), static_cast<int>(height));
+    size_t columns = static_cast<size_t>(width) * stride + 1;
+    int stripeCount = static_cast<int>(std::min<long long>(threads, height));
+
+    maze->rewriteWallMasks([&](uint8_t* masks) {
+        TRACE_SCOPE("mazetext", "parse rows");
+        forEachStripe(stripeCount, static_cast<size_t>(height), [&](int, size_t y0, size_t y1) {
+            // Walls of the lines above, through and below the current row
+            std::vector<uint64_t> above((columns + 63) / 64), through(above.size()), below(above.size());
+            const char* line;
+            size_t length;
+            index.line(2 * y0, line, length);
+            classifyLine(line, length, columns, above);
+
+            for (size_t y = y0; y < y1; y++) {
+                index.line(2 * y + 1, line, length);
+                classifyLine(line, length, columns, through);
+                index.line(2 * y + 2, line, length);
+                classifyLine(line, length, columns, below);
+
+                uint8_t* row = masks + y * width;
+                for (long long x = 0; x < width; x++) {
+                    size_t column = static_cast<size_t>(x) * stride;
+                    row[x] = static_cast<uint8_t>(bitAt(above, column + 1) * WallTop |
+                                                  bitAt(through, column + stride) * WallRight |
+                                                  bitAt(below, column + 1) * WallBottom |
+                                                  bitAt(through, column) * WallLeft);
+                }
+                above.swap(below);
+            }
+        });
+    }, threads);
+    return maze;
+}
+
+std::unique_ptr<Maze> loadTextMaze(const std::string& filename, std::string* error, int threads) {
+    TRACE_SCOPE("mazetext", "loadTextMaze");
+    MappedFile file;
+    if (!file.open(filename, error)) return nullptr;
+    std::string message;
+    std::unique_ptr<Maze> maze = parseTextMaze(file.data(), file.size(), &message, threads);
+    if (!maze) setError(error, filename + ": " + message);
+    return maze;
+}
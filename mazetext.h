@@ -0,0 +1,47 @@
+#ifndef MAZETEXT_H
+#define MAZETEXT_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "maze.h"
+
+// Plain-text mazes as other tools draw them. A maze of W x H cells is
+// 2H + 1 lines; even lines hold horizontal walls, odd lines vertical walls
+// and cell interiors.
+//   Blocks: one character per wall or cell, '#' for walls, e.g.
+//             #####
+//             #   #
+//             # ###
+//   Lines:  '+' corners, "--" horizontal and '|' vertical walls, e.g.
+//             +--+--+
+//             |     |
+//             +  +--+
+// On import any character other than a space counts as a wall, lines may
+// end in \r\n, and short lines are padded with spaces. The style is taken
+// from the first line: Lines when it starts with '+' (the cell width is the
+// distance to the next '+'), Blocks otherwise.
+enum class TextMazeStyle { Blocks, Lines };
+
+// A wall shared by two cells is drawn when either cell has it
+bool saveTextMaze(const Maze& maze, const std::string& filename, TextMazeStyle style,
+                  std::string* error = nullptr);
+
+// The same text held in memory
+std::string formatTextMaze(const Maze& maze, TextMazeStyle style);
+
+// Memory-maps the file, indexes its lines and parses maze rows in parallel
+// on up to threads threads (0 = all cores), classifying 16 bytes at a time
+// with SSE2 where available. Masks go straight into the Maze's storage.
+// Returns nullptr (and fills error if given) when the text is not a maze.
+std::unique_ptr<Maze> loadTextMaze(const std::string& filename, std::string* error = nullptr,
+                                   int threads = 0);
+
+// The same parser over text already in memory
+std::unique_ptr<Maze> parseTextMaze(const char* text, size_t size, std::string* error = nullptr,
+                                    int threads = 0);
+
+// Whether a path names a text maze (.txt), for callers choosing a format
+bool isTextMazePath(const std::string& filename);
+
+#endif // MAZETEXT_H
@@ -0,0 +1,52 @@
+#ifndef MAZEUTIL_H
+#define MAZEUTIL_H
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Small helpers shared by the mazecore sources; not part of the public API.
+
+// Error reporting for loaders and savers: error may be nullptr
+inline void setError(std::string* error, const std::string& message) {
+    if (error) *error = message;
+}
+
+// Thread count for a threads option, where 0 or less means all cores
+inline int resolveThreads(int threads) {
+    if (threads <= 0) threads = static_cast<int>(std::thread::hardware_concurrency());
+    return threads > 0 ? threads : 1;
+}
+
+// Runs work(stripe, first, end) over [0, count) split into stripeCount
+// contiguous ranges: stripe 0 on the calling thread, one new thread for
+// each of the others
+template <typename Index, typename Work>
+void forEachStripe(int stripeCount, Index count, Work work) {
+    auto bounds = [&](int s) {
+        return static_cast<Index>(static_cast<uint64_t>(count) * static_cast<uint64_t>(s) / stripeCount);
+    };
+    std::vector<std::thread> workers;
+    for (int s = 1; s < stripeCount; s++) {
+        workers.emplace_back([&, s] { work(s, bounds(s), bounds(s + 1)); });
+    }
+    work(0, Index(0), bounds(1));
+    for (std::thread& t : workers) t.join();
+}
+
+// One byte per cell inside a 64-bit word: k * LowBytes repeats k in every byte
+constexpr uint64_t LowBytes = 0x0101010101010101ULL;
+
+inline int popcount64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(v);
+#else
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<int>((v * LowBytes) >> 56);
+#endif
+}
+
+#endif // MAZEUTIL_H
@@ -0,0 +1,213 @@
+#include "mazevalidator.h"
+#include "mazeutil.h"
+#include "memorytracker.h"
+#include "tracer.h"
+#include <algorithm>
+#include <cstring>
+#include <memory_resource>
+
+namespace {
+
+// Byte lane of the lowest set bit
+int lowestLane(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(v) / 8;
+#else
+    int lane = 0;
+    while (!(v & 0xff)) { v >>= 8; lane++; }
+    return lane;
+#endif
+}
+
+// Up to eight cells of a row as one word; cells past the row are closed
+uint64_t loadCells(const uint8_t* row, int x, int width) {
+    uint8_t bytes[8];
+    std::memset(bytes, AllWalls, sizeof(bytes));
+    int n = std::clamp(width - x, 0, 8);
+    if (n > 0) std::memcpy(bytes, row + x, n);
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+// Low bit of the first n byte lanes
+uint64_t lanes(int n) {
+    return n >= 8 ? LowBytes : LowBytes & ((1ULL << (8 * n)) - 1);
+}
+
+// Union-find over one parent array shared by all stripes. A root is the
+// smallest index in its set, so it is the set's first cell in row-major order.
+int findRoot(int* parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];   // path halving
+        x = parent[x];
+    }
+    return x;
+}
+
+bool link(int* parent, int a, int b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a == b) return false;
+    if (a < b) parent[b] = a;
+    else parent[a] = b;
+    return true;
+}
+
+// Read-only find, safe while other threads do the same
+int peekRoot(const int* parent, int x) {
+    while (parent[x] != x) x = parent[x];
+    return x;
+}
+
+struct StripeResult {
+    long long passages = 0;
+    long long mismatched = 0;
+    long long openBorder = 0;
+    long long unions = 0;
+    std::vector<WallMismatch> mismatches;
+};
+
+void noteMismatches(uint64_t bits, int x, int y, int direction, StripeResult& out) {
+    out.mismatched += popcount64(bits);
+    for (; bits && out.mismatches.size() < MazeValidation::MaxListed; bits &= bits - 1) {
+        out.mismatches.push_back({x + lowestLane(bits), y, direction});
+    }
+}
+
+// Symmetry, border and passage checks plus union-find inside rows [y0, y1).
+// Passages down into the next stripe are counted here but joined later.
+void validateStripe(const uint8_t* masks, int width, int height, int y0, int y1,
+                    int* parent, StripeResult& out) {
+    int first = y0 * width, last = y1 * width;
+    for (int cell = first; cell < last; cell++) parent[cell] = cell;
+
+    for (int y = y0; y < y1; y++) {
+        const uint8_t* row = masks + static_cast<size_t>(y) * width;
+        const uint8_t* below = y + 1 < height ? row + width : nullptr;
+
+        for (int x = 0; x < width; x += 8) {
+            int n = std::min(8, width - x);
+            uint64_t inRow = lanes(n);
+            uint64_t word = loadCells(row, x, width);
+
+            // Right side of each cell against the left side of the next one
+            uint64_t pairs = x + n == width ? lanes(n - 1) : inRow;
+            uint64_t right = (word >> 1) & LowBytes;
+            uint64_t left = (loadCells(row, x + 1, width) >> 3) & LowBytes;
+            uint64_t openRight = ~(right | left) & pairs;
+            noteMismatches((right ^ left) & pairs, x, y, 1, out);
+
+            // Bottom side against the top side of the cell below
+            uint64_t openDown = 0;
+            if (below) {
+                uint64_t bottom = (word >> 2) & LowBytes;
+                uint64_t top = loadCells(below, x, width) & LowBytes;
+                openDown = ~(bottom | top) & inRow;
+                noteMismatches((bottom ^ top) & inRow, x, y, 2, out);
+            }
+
+            // The outer boundary must be closed all round
+            if (y == 0) out.openBorder += popcount64(~word & inRow);
+            if (y == height - 1) out.openBorder += popcount64(~(word >> 2) & inRow);
+            if (x == 0) out.openBorder += ~(word >> 3) & 1;
+            if (x + n == width) out.openBorder += (~(word >> 1) >> (8 * (n - 1))) & 1;
+
+            out.passages += popcount64(openRight) + popcount64(openDown);
+
+            int base = y * width + x;
+            for (; openRight; openRight &= openRight - 1) {
+                int cell = base + lowestLane(openRight);
+                out.unions += link(parent, cell, cell + 1);
+            }
+            if (y + 1 < y1) {
+                for (; openDown; openDown &= openDown - 1) {
+                    int cell = base + lowestLane(openDown);
+                    out.unions += link(parent, cell, cell + width);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+MazeValidation validateMaze(const Maze& maze, int threads) {
+    TRACE_SCOPE("validator", "validateMaze");
+    MazeValidation report;
+    int width = maze.getWidth(), height = maze.getHeight();
+    const uint8_t* masks = maze.wallMasks();
+    report.cells = static_cast<long long>(width) * height;
+    if (report.cells == 0) return report;
+
+    int stripeCount = std::clamp(resolveThreads(threads), 1, height);
+    auto bounds = [&](int s) { return static_cast<int>(static_cast<long long>(height) * s / stripeCount); };
+
+    std::pmr::memory_resource* resource = MemoryTracker::resource(MemorySubsystem::UnionFind);
+    std::pmr::vector<int> parent(static_cast<size_t>(report.cells), resource);
+    std::vector<StripeResult> stripes(stripeCount);
+    {
+        TRACE_SCOPE("validator", "stripe pass");
+        forEachStripe(stripeCount, height, [&](int s, int y0, int y1) {
+            validateStripe(masks, width, height, y0, y1, parent.data(), stripes[s]);
+        });
+    }
+
+    long long unions = 0;
+    for (const StripeResult& stripe : stripes) {
+        report.passages += stripe.passages;
+        report.mismatchedWalls += stripe.mismatched;
+        report.openBorderWalls += stripe.openBorder;
+        unions += stripe.unions;
+        for (const WallMismatch& m : stripe.mismatches) {
+            if (report.mismatches.size() < MazeValidation::MaxListed) report.mismatches.push_back(m);
+        }
+    }
+
+    // Join each stripe to the next along the row pair that straddles them
+    {
+        TRACE_SCOPE("validator", "merge borders");
+        for (int s = 1; s < stripeCount; s++) {
+            int y = bounds(s) - 1;
+            const uint8_t* row = masks + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; x++) {
+                if (!(row[x] & WallBottom) && !(row[x + width] & WallTop)) {
+                    unions += link(parent.data(), y * width + x, (y + 1) * width + x);
+                }
+            }
+        }
+    }
+    report.components = report.cells - unions;
+    report.cycleRank = report.passages - report.cells + report.components;
+    if (report.components == 1) return report;
+
+    // Label every cell with its root in parallel, then size the regions the
+    // start corner's root does not own, reusing parent as the counters
+    TRACE_SCOPE("validator", "unreachable regions");
+    std::pmr::vector<int> label(static_cast<size_t>(report.cells), resource);
+    forEachStripe(stripeCount, height, [&](int, int y0, int y1) {
+        for (int cell = y0 * width; cell < y1 * width; cell++) label[cell] = peekRoot(parent.data(), cell);
+    });
+    std::fill(parent.begin(), parent.end(), 0);
+    int startRoot = label[0];
+    for (size_t cell = 0; cell < label.size(); cell++) {
+        if (label[cell] != startRoot) parent[label[cell]]++;
+    }
+
+    for (size_t cell = 0; cell < label.size(); cell++) {
+        if (label[cell] != static_cast<int>(cell) || label[cell] == startRoot) continue;
+        report.unreachableCells += parent[cell];
+        report.unreachable.push_back({static_cast<int>(cell % width), static_cast<int>(cell / width), parent[cell]});
+    }
+    auto larger = [](const UnreachableRegion& a, const UnreachableRegion& b) {
+        return a.cells != b.cells ? a.cells > b.cells : (a.y != b.y ? a.y < b.y : a.x < b.x);
+    };
+    if (report.unreachable.size() > MazeValidation::MaxListed) {
+        std::partial_sort(report.unreachable.begin(), report.unreachable.begin() + MazeValidation::MaxListed,
+                          report.unreachable.end(), larger);
+        report.unreachable.resize(MazeValidation::MaxListed);
+    } else {
+        std::sort(report.unreachable.begin(), report.unreachable.end(), larger);
+    }
+    return report;
+}
@@ -0,0 +1,48 @@
+#ifndef MAZEVALIDATOR_H
+#define MAZEVALIDATOR_H
+
+#include <vector>
+#include "maze.h"
+
+// A shared wall whose two copies disagree: the cell's side in direction
+// (1 = right, 2 = bottom) does not match its neighbour's opposite side
+struct WallMismatch {
+    int x, y, direction;
+};
+
+// A connected region that the start corner (0, 0) cannot reach, named by
+// its first cell in row-major order
+struct UnreachableRegion {
+    int x, y;
+    long long cells;
+};
+
+// Integrity report. Passages count only walls open on both sides, so a
+// one-sided opening connects nothing and shows up as a mismatch instead.
+struct MazeValidation {
+    static constexpr size_t MaxListed = 64;   // cap on mismatches and regions kept
+
+    long long cells = 0;
+    long long passages = 0;
+    long long mismatchedWalls = 0;
+    long long openBorderWalls = 0;      // outer walls that are missing
+    long long components = 0;
+    long long cycleRank = 0;            // passages - cells + components
+    long long unreachableCells = 0;
+    std::vector<WallMismatch> mismatches;           // first MaxListed, row-major
+    std::vector<UnreachableRegion> unreachable;     // largest MaxListed regions
+
+    bool symmetric() const { return mismatchedWalls == 0 && openBorderWalls == 0; }
+    bool connected() const { return components == 1; }
+    // Symmetric, connected and loop-free: what generateMaze(0) produces
+    bool perfect() const { return symmetric() && connected() && cycleRank == 0; }
+};
+
+// Checks wall symmetry and labels connected components over row stripes on
+// up to threads threads (1 = inline, 0 = one per hardware thread). Each
+// stripe runs its own union-find; the stripes are then joined along their
+// border rows. A maze generated with extraCycles loops has cycleRank equal
+// to extraCycles (fewer only when the maze has no more walls to open).
+MazeValidation validateMaze(const Maze& maze, int threads = 1);
+
+#endif // MAZEVALIDATOR_H
@@ -0,0 +1,146 @@
+#include "memorytracker.h"
+#include <atomic>
+#include <cstdio>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const int subsystemCount = static_cast<int>(MemorySubsystem::Count);
+
+const char* subsystemNames[subsystemCount] = {
+    "Maze grid",
+    "Wall removal order",
+    "Cell weights",
+    "Generation walls",
+    "Union-Find",
+    "Path results",
+    "Solver scratch",
+    "Arena"
+};
+
+struct Counters {
+    std::atomic<long long> current{0};
+    std::atomic<long long> peak{0};
+    std::atomic<long long> allocations{0};
+};
+
+Counters counters[subsystemCount];
+
+} // namespace
+
+TrackingResource::TrackingResource(MemorySubsystem s, std::pmr::memory_resource* up)
+    : subsystem(s), upstream(up) {}
+
+void* TrackingResource::do_allocate(size_t bytes, size_t alignment) {
+    void* p = upstream->allocate(bytes, alignment);
+    MemoryTracker::recordAllocate(subsystem, bytes);
+    return p;
+}
+
+void TrackingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    upstream->deallocate(p, bytes, alignment);
+    MemoryTracker::recordDeallocate(subsystem, bytes);
+}
+
+bool TrackingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+std::pmr::memory_resource* MemoryTracker::resource(MemorySubsystem subsystem) {
+    static TrackingResource resources[subsystemCount] = {
+        TrackingResource(MemorySubsystem::MazeGrid),
+        TrackingResource(MemorySubsystem::WallRemovalOrder),
+        TrackingResource(MemorySubsystem::MazeWeights),
+        TrackingResource(MemorySubsystem::GenerationWalls),
+        TrackingResource(MemorySubsystem::UnionFind),
+        TrackingResource(MemorySubsystem::PathResult),
+        TrackingResource(MemorySubsystem::SolverScratch),
+        TrackingResource(MemorySubsystem::Arena)
+    };
+    return &resources[static_cast<int>(subsystem)];
+}
+
+void MemoryTracker::recordAllocate(MemorySubsystem subsystem, size_t bytes) {
+    Counters& c = counters[static_cast<int>(subsystem)];
+    long long now = c.current.fetch_add(static_cast<long long>(bytes), std::memory_order_relaxed)
+                  + static_cast<long long>(bytes);
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+
+    long long peak = c.peak.load(std::memory_order_relaxed);
+    while (now > peak && !c.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+}
+
+void MemoryTracker::recordDeallocate(MemorySubsystem subsystem, size_t bytes) {
+    counters[static_cast<int>(subsystem)].current.fetch_sub(static_cast<long long>(bytes),
+                                                             std::memory_order_relaxed);
+}
+
+SubsystemMemory MemoryTracker::stats(MemorySubsystem subsystem) {
+    const Counters& c = counters[static_cast<int>(subsystem)];
+    return {
+        subsystemNames[static_cast<int>(subsystem)],
+        c.current.load(std::memory_order_relaxed),
+        c.peak.load(std::memory_order_relaxed),
+        c.allocations.load(std::memory_order_relaxed)
+    };
+}
+
+std::vector<SubsystemMemory> MemoryTracker::snapshot() {
+    std::vector<SubsystemMemory> all;
+    for (int i = 0; i < subsystemCount; i++) {
+        all.push_back(stats(static_cast<MemorySubsystem>(i)));
+    }
+    return all;
+}
+
+void MemoryTracker::resetPeaks() {
+    for (Counters& c : counters) {
+        c.peak.store(c.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+long long MemoryTracker::peakRssBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS info;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info))) {
+        return static_cast<long long>(info.PeakWorkingSetSize);
+    }
+    return -1;
+#elif defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#if defined(__APPLE__)
+    return static_cast<long long>(usage.ru_maxrss);          // bytes on macOS
+#else
+    return static_cast<long long>(usage.ru_maxrss) * 1024;   // kilobytes elsewhere
+#endif
+#else
+    return -1;
+#endif
+}
+
+long long MemoryTracker::currentRssBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS info;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info))) {
+        return static_cast<long long>(info.WorkingSetSize);
+    }
+    return -1;
+#elif defined(__linux__)
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) return -1;
+    long long pages = 0, resident = 0;
+    int fields = std::fscanf(statm, "%lld %lld", &pages, &resident);
+    std::fclose(statm);
+    return fields == 2 ? resident * sysconf(_SC_PAGESIZE) : -1;
+#else
+    return -1;
+#endif
+}
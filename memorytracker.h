@@ -0,0 +1,64 @@
+#ifndef MEMORYTRACKER_H
+#define MEMORYTRACKER_H
+
+#include <memory_resource>
+#include <vector>
+
+// Subsystems whose containers allocate through a tracked resource
+enum class MemorySubsystem {
+    MazeGrid,           // Maze cell storage
+    WallRemovalOrder,   // Maze::wallRemovalOrder (kept for animation)
+    MazeWeights,        // optional per-cell terrain costs
+    GenerationWalls,    // transient walls/skippedWalls in generateMaze
+    UnionFind,          // parent/rank arrays
+    PathResult,         // path and explored lists handed back to callers
+    SolverScratch,      // visited/parent/frontier inside a solve
+    Arena,              // blocks owned by MazeArena instances
+    Count
+};
+
+struct SubsystemMemory {
+    const char* name;
+    long long currentBytes;
+    long long peakBytes;
+    long long allocations;   // number of allocate calls so far
+};
+
+// pmr resource that forwards to an upstream resource and accounts every
+// byte to one subsystem. Counters are atomic, so solver threads can share it.
+class TrackingResource : public std::pmr::memory_resource {
+private:
+    MemorySubsystem subsystem;
+    std::pmr::memory_resource* upstream;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+public:
+    TrackingResource(MemorySubsystem s, std::pmr::memory_resource* up = std::pmr::new_delete_resource());
+    MemorySubsystem getSubsystem() const { return subsystem; }
+};
+
+class MemoryTracker {
+public:
+    // Process-wide tracked resource for a subsystem (new/delete upstream)
+    static std::pmr::memory_resource* resource(MemorySubsystem subsystem);
+
+    static SubsystemMemory stats(MemorySubsystem subsystem);
+    static std::vector<SubsystemMemory> snapshot();
+
+    // Restart peak tracking from the current usage
+    static void resetPeaks();
+
+    // Operating-system view of the whole process; -1 where unavailable
+    static long long peakRssBytes();
+    static long long currentRssBytes();
+
+    // Called by TrackingResource
+    static void recordAllocate(MemorySubsystem subsystem, size_t bytes);
+    static void recordDeallocate(MemorySubsystem subsystem, size_t bytes);
+};
+
+#endif // MEMORYTRACKER_H
@@ -1,123 +1,387 @@
 #include "pathfinder.h"
+#include "tracer.h"
 #include <algorithm> // it contains std::reverse that's used in path reconstruction
-#include <cstdlib> // for std::rand, std::srand that might be used in pathfinding variations
-#include <ctime> // for std::time to seed random number generator
+#include <cctype>
+#include <chrono>
+#include <functional>
+#include "radixheap.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+long long elapsedNs(Clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count();
+}
+
+template <typename T>
+long long heldBytes(const std::pmr::vector<T>& v) {
+    return static_cast<long long>(v.capacity() * sizeof(T));
+}
+
+} // namespace
 
 PathFinder::PathFinder(const Maze* m, int sx, int sy, int ex, int ey)
-    : maze(m), startX(sx), startY(sy), endX(ex), endY(ey) {}
+    : maze(m), startX(sx), startY(sy), endX(ex), endY(ey), progress(nullptr),
+      scratchResource(MemoryTracker::resource(MemorySubsystem::SolverScratch)),
+      resultResource(MemoryTracker::resource(MemorySubsystem::PathResult)),
+      layout(nullptr), masks(nullptr) {}
+
+void PathFinder::setScratchResource(std::pmr::memory_resource* r) {
+    scratchResource = r ? r : MemoryTracker::resource(MemorySubsystem::SolverScratch);
+}
+
+void PathFinder::setResultResource(std::pmr::memory_resource* r) {
+    resultResource = r ? r : MemoryTracker::resource(MemorySubsystem::PathResult);
+}
+
+const std::vector<AlgorithmInfo>& PathFinder::algorithms() {
+    static const std::vector<AlgorithmInfo> registry = {
+        {Algorithm::BFS, "BFS"},
+        {Algorithm::DFS, "DFS"},
+        {Algorithm::Dijkstra, "Dijkstra"}
+    };
+    return registry;
+}
+
+bool PathFinder::findAlgorithm(const std::string& name, Algorithm& out) {
+    for (const AlgorithmInfo& info : algorithms()) {
+        std::string registered = info.name;
+        if (registered.size() != name.size()) continue;
+        bool same = true;
+        for (size_t i = 0; i < name.size() && same; i++) {
+            same = std::tolower(static_cast<unsigned char>(name[i]))
+                == std::tolower(static_cast<unsigned char>(registered[i]));
+        }
+        if (same) {
+            out = info.id;
+            return true;
+        }
+    }
+    return false;
+}
+
+PathResult PathFinder::solve(Algorithm algorithm) {
+    switch (algorithm) {
+        case Algorithm::BFS: return solveBFS();
+        case Algorithm::DFS: return solveDFS();
+        case Algorithm::Dijkstra: return solveDijkstra();
+    }
+    return PathResult(resultResource);
+}
+
+void PathFinder::beginProgress(PathResult& result, size_t cellCount) const {
+    if (!progress) return;
+    // Reserve so the buffer never reallocates under a reader
+    result.explored.reserve(cellCount);
+    progress->exploredCount.store(0, std::memory_order_relaxed);
+    progress->nodesExpanded.store(0, std::memory_order_relaxed);
+    progress->explored.store(result.explored.data(), std::memory_order_release);
+}
+
+bool PathFinder::publishProgress(const PathResult& result) const {
+    progress->nodesExpanded.store(result.stepsCount, std::memory_order_relaxed);
+    progress->exploredCount.store(static_cast<long long>(result.explored.size()),
+                                  std::memory_order_release);
+    return progress->stop.load(std::memory_order_relaxed);
+}
 
 bool PathFinder::isValid(int x, int y) const {
     return x >= 0 && x < maze->getWidth() && y >= 0 && y < maze->getHeight();
 }
 
-std::vector<std::pair<int, int>> PathFinder::getNeighbors(int x, int y) const {
-    std::vector<std::pair<int, int>> neighbors;
-    
+void PathFinder::bindLayout() {
+    layout = &maze->getCellLayout();
+    masks = maze->layoutMasks();
+}
+
+int PathFinder::getNeighbors(int x, int y, int cell, Neighbor out[4]) const {
+    int count = 0;
+    uint8_t mask = masks[cell];
+
     // Check all 4 directions: top, right, bottom, left
-    if (!maze->hasWall(x, y, 0) && isValid(x, y - 1)) 
-        neighbors.push_back({x, y - 1});
-    if (!maze->hasWall(x, y, 1) && isValid(x + 1, y)) 
-        neighbors.push_back({x + 1, y});
-    if (!maze->hasWall(x, y, 2) && isValid(x, y + 1)) 
-        neighbors.push_back({x, y + 1});
-    if (!maze->hasWall(x, y, 3) && isValid(x - 1, y)) 
-        neighbors.push_back({x - 1, y});
-    
-    return neighbors;
+    if (!(mask & WallTop) && isValid(x, y - 1))
+        out[count++] = {x, y - 1, static_cast<int>(layout->index(x, y - 1))};
+    if (!(mask & WallRight) && isValid(x + 1, y))
+        out[count++] = {x + 1, y, static_cast<int>(layout->index(x + 1, y))};
+    if (!(mask & WallBottom) && isValid(x, y + 1))
+        out[count++] = {x, y + 1, static_cast<int>(layout->index(x, y + 1))};
+    if (!(mask & WallLeft) && isValid(x - 1, y))
+        out[count++] = {x - 1, y, static_cast<int>(layout->index(x - 1, y))};
+
+    return count;
+}
+
+void PathFinder::reconstructPath(PathResult& result, const std::pmr::vector<int>& parent) const {
+    TRACE_SCOPE("solve", "reconstruct path");
+    auto start = Clock::now();
+    for (int cell = static_cast<int>(layout->index(endX, endY)); cell != -1; cell = parent[cell]) {
+        int x, y;
+        layout->coords(cell, x, y);
+        result.path.push_back({x, y});
+    }
+    std::reverse(result.path.begin(), result.path.end());
+
+    // Cost of entering every cell after the start
+    result.totalCost = 0;
+    for (size_t i = 1; i < result.path.size(); i++) {
+        result.totalCost += maze->getWeight(result.path[i].first, result.path[i].second);
+    }
+
+    result.stats.reconstructNs = elapsedNs(start);
 }
 
 PathResult PathFinder::solveBFS() {
-    PathResult result;
-    
-    std::vector<std::vector<bool>> visited(maze->getHeight(), 
-                                           std::vector<bool>(maze->getWidth(), false));
-    std::vector<std::vector<std::pair<int, int>>> parent(maze->getHeight(),
-                                                         std::vector<std::pair<int, int>>(maze->getWidth(), {-1, -1}));
-    
-    std::queue<std::pair<int, int>> q;
-    q.push({startX, startY});
-    visited[startY][startX] = true;
+    TRACE_SCOPE("solve", "BFS");
+    PathResult result(resultResource);
+    SearchStats& stats = result.stats;
+    auto setupStart = Clock::now();
+
+    bindLayout();
+    size_t cellCount = static_cast<size_t>(maze->getWidth()) * maze->getHeight();
+    size_t slots = layout->size();
+    std::pmr::memory_resource* scratch = scratchResource;
+    std::pmr::vector<unsigned char> visited(slots, 0, scratch);
+    std::pmr::vector<int> parent(slots, -1, scratch);
+
+    // FIFO queue as a vector plus read index: each cell enters at most once
+    std::pmr::vector<int> queue(scratch);
+    queue.reserve(cellCount);
+    size_t head = 0;
+
+    beginProgress(result, cellCount);
+    stats.setupNs = elapsedNs(setupStart);
+
+    auto start = Clock::now();
+    int startCell = static_cast<int>(layout->index(startX, startY));
+    queue.push_back(startCell);
+    visited[startCell] = 1;
     result.explored.push_back({startX, startY});
-    
-    while (!q.empty()) {
-        auto [x, y] = q.front();
-        q.pop();
+    stats.peakFrontier = 1;
+
+    Neighbor neighbors[4];
+    while (head < queue.size()) {
+        int cell = queue[head++];
+        int x, y;
+        layout->coords(cell, x, y);
         result.stepsCount++;
-        
+        if (progress && (result.stepsCount & 63) == 0 && publishProgress(result)) {
+            break;
+        }
+
         if (x == endX && y == endY) {
             result.found = true;
-            
-            // Reconstruct path
-            int cx = endX, cy = endY;
-            while (cx != -1 && cy != -1) {
-                result.path.push_back({cx, cy});
-                auto [px, py] = parent[cy][cx];
-                cx = px;
-                cy = py;
-            }
-            std::reverse(result.path.begin(), result.path.end());
-            return result;
+            break;
         }
-        
-        for (auto [nx, ny] : getNeighbors(x, y)) {
-            if (!visited[ny][nx]) {
-                visited[ny][nx] = true;
-                parent[ny][nx] = {x, y};
-                q.push({nx, ny});
-                result.explored.push_back({nx, ny});
+
+        int count = getNeighbors(x, y, cell, neighbors);
+        stats.neighborChecks += count;
+        for (int i = 0; i < count; i++) {
+            const Neighbor& n = neighbors[i];
+            if (!visited[n.cell]) {
+                visited[n.cell] = 1;
+                parent[n.cell] = cell;
+                queue.push_back(n.cell);
+                result.explored.push_back({n.x, n.y});
             }
         }
+        stats.peakFrontier = std::max(stats.peakFrontier, static_cast<long long>(queue.size() - head));
+    }
+
+    stats.searchNs = elapsedNs(start);
+    stats.nodesExpanded = result.stepsCount;
+    if (progress) {
+        publishProgress(result);
+    }
+
+    if (result.found) {
+        reconstructPath(result, parent);
     }
-    
+
+    stats.bytesAllocated = heldBytes(visited) + heldBytes(parent) + heldBytes(queue)
+                         + heldBytes(result.explored) + heldBytes(result.path);
     return result;
 }
 
 PathResult PathFinder::solveDFS() {
-    PathResult result;
-    
-    std::vector<std::vector<bool>> visited(maze->getHeight(), 
-                                           std::vector<bool>(maze->getWidth(), false));
-    std::vector<std::vector<std::pair<int, int>>> parent(maze->getHeight(),
-                                                         std::vector<std::pair<int, int>>(maze->getWidth(), {-1, -1}));
-    
-    std::stack<std::pair<int, int>> st;
-    st.push({startX, startY});
-    visited[startY][startX] = true;
+    TRACE_SCOPE("solve", "DFS");
+    PathResult result(resultResource);
+    SearchStats& stats = result.stats;
+    auto setupStart = Clock::now();
+
+    bindLayout();
+    size_t cellCount = static_cast<size_t>(maze->getWidth()) * maze->getHeight();
+    size_t slots = layout->size();
+    std::pmr::memory_resource* scratch = scratchResource;
+    std::pmr::vector<unsigned char> visited(slots, 0, scratch);
+    std::pmr::vector<int> parent(slots, -1, scratch);
+    std::pmr::vector<int> stack(scratch);
+
+    beginProgress(result, cellCount);
+    stats.setupNs = elapsedNs(setupStart);
+
+    auto start = Clock::now();
+    int startCell = static_cast<int>(layout->index(startX, startY));
+    stack.push_back(startCell);
+    visited[startCell] = 1;
     result.explored.push_back({startX, startY});
-    
-    while (!st.empty()) {
-        auto [x, y] = st.top();
-        st.pop();
+    stats.peakFrontier = 1;
+
+    Neighbor neighbors[4];
+    while (!stack.empty()) {
+        int cell = stack.back();
+        stack.pop_back();
+        int x, y;
+        layout->coords(cell, x, y);
         result.stepsCount++;
-        
+        if (progress && (result.stepsCount & 63) == 0 && publishProgress(result)) {
+            break;
+        }
+
         if (x == endX && y == endY) {
             result.found = true;
-            
-            // Reconstruct path
-            int cx = endX, cy = endY;
-            while (cx != -1 && cy != -1) {
-                result.path.push_back({cx, cy});
-                auto [px, py] = parent[cy][cx];
-                cx = px;
-                cy = py;
-            }
-            std::reverse(result.path.begin(), result.path.end());
-            return result;
+            break;
         }
-        
-        // Get neighbors and reverse them for DFS (different exploration order than BFS)
-        auto neighbors = getNeighbors(x, y);
-        std::reverse(neighbors.begin(), neighbors.end());
-        
-        for (auto [nx, ny] : neighbors) {
-            if (!visited[ny][nx]) {
-                visited[ny][nx] = true;
-                parent[ny][nx] = {x, y};
-                st.push({nx, ny});
-                result.explored.push_back({nx, ny});
+
+        // Push neighbors in reverse for DFS (different exploration order than BFS)
+        int count = getNeighbors(x, y, cell, neighbors);
+        stats.neighborChecks += count;
+        for (int i = count - 1; i >= 0; i--) {
+            const Neighbor& n = neighbors[i];
+            if (!visited[n.cell]) {
+                visited[n.cell] = 1;
+                parent[n.cell] = cell;
+                stack.push_back(n.cell);
+                result.explored.push_back({n.x, n.y});
             }
         }
+        stats.peakFrontier = std::max(stats.peakFrontier, static_cast<long long>(stack.size()));
+    }
+
+    stats.searchNs = elapsedNs(start);
+    stats.nodesExpanded = result.stepsCount;
+    if (progress) {
+        publishProgress(result);
+    }
+
+    if (result.found) {
+        reconstructPath(result, parent);
+    }
+
+    stats.bytesAllocated = heldBytes(visited) + heldBytes(parent) + heldBytes(stack)
+                         + heldBytes(result.explored) + heldBytes(result.path);
+    return result;
+}
+
+namespace {
+
+// Binary min-heap (push_heap/pop_heap, as std::priority_queue) with the
+// RadixHeap interface, for comparison runs. The vector is kept in the open
+// so heldBytes reports its capacity, as RadixHeap does for its buckets.
+class BinaryHeap {
+private:
+    using Entry = std::pair<uint64_t, int>;
+    std::pmr::vector<Entry> heap;
+
+public:
+    explicit BinaryHeap(std::pmr::memory_resource* resource) : heap(resource) {}
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    void push(uint64_t key, int value) {
+        heap.emplace_back(key, value);
+        std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+    }
+    Entry pop() {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+        Entry top = heap.back();
+        heap.pop_back();
+        return top;
+    }
+    size_t heldBytes() const { return heap.capacity() * sizeof(Entry); }
+};
+
+} // namespace
+
+PathResult PathFinder::solveDijkstra(PriorityQueueKind kind) {
+    TRACE_SCOPE("solve", "Dijkstra");
+    PathResult result(resultResource);
+    if (kind == PriorityQueueKind::Binary) {
+        BinaryHeap queue(scratchResource);
+        runDijkstra(result, queue, scratchResource);
+    } else {
+        RadixHeap<int> queue(scratchResource);
+        runDijkstra(result, queue, scratchResource);
     }
-    
     return result;
-}
\ No newline at end of file
+}
+
+template <typename Queue>
+void PathFinder::runDijkstra(PathResult& result, Queue& queue, std::pmr::memory_resource* scratch) {
+    SearchStats& stats = result.stats;
+    auto setupStart = Clock::now();
+
+    bindLayout();
+    size_t cellCount = static_cast<size_t>(maze->getWidth()) * maze->getHeight();
+    size_t slots = layout->size();
+    std::pmr::vector<uint64_t> dist(slots, UINT64_MAX, scratch);
+    std::pmr::vector<int> parent(slots, -1, scratch);
+    std::pmr::vector<unsigned char> settled(slots, 0, scratch);
+
+    beginProgress(result, cellCount);
+    stats.setupNs = elapsedNs(setupStart);
+
+    auto start = Clock::now();
+    int startCell = static_cast<int>(layout->index(startX, startY));
+    dist[startCell] = 0;
+    queue.push(0, startCell);
+    stats.peakFrontier = 1;
+
+    Neighbor neighbors[4];
+    while (!queue.empty()) {
+        auto [cost, cell] = queue.pop();
+        // Lazy deletion: skip entries superseded by a cheaper push
+        if (settled[cell] || cost > dist[cell]) continue;
+        settled[cell] = 1;
+
+        int x, y;
+        layout->coords(cell, x, y);
+        result.explored.push_back({x, y});
+        result.stepsCount++;
+        if (progress && (result.stepsCount & 63) == 0 && publishProgress(result)) {
+            break;
+        }
+
+        if (x == endX && y == endY) {
+            result.found = true;
+            break;
+        }
+
+        int count = getNeighbors(x, y, cell, neighbors);
+        stats.neighborChecks += count;
+        for (int i = 0; i < count; i++) {
+            const Neighbor& n = neighbors[i];
+            uint64_t through = cost + static_cast<uint64_t>(maze->getWeight(n.x, n.y));
+            if (!settled[n.cell] && through < dist[n.cell]) {
+                dist[n.cell] = through;
+                parent[n.cell] = cell;
+                queue.push(through, n.cell);
+            }
+        }
+        stats.peakFrontier = std::max(stats.peakFrontier, static_cast<long long>(queue.size()));
+    }
+
+    stats.searchNs = elapsedNs(start);
+    stats.nodesExpanded = result.stepsCount;
+    if (progress) {
+        publishProgress(result);
+    }
+
+    if (result.found) {
+        reconstructPath(result, parent);
+    }
+
+    stats.bytesAllocated = heldBytes(dist) + heldBytes(parent) + heldBytes(settled)
+                         + static_cast<long long>(queue.heldBytes())
+                         + heldBytes(result.explored) + heldBytes(result.path);
+}
@@ -1,34 +1,116 @@
 #ifndef PATHFINDER_H
 #define PATHFINDER_H
 
+#include <atomic>
+#include <memory_resource>
+#include <string>
 #include <vector>
 #include <queue>
 #include <stack>
 #include "maze.h"
 
+// Instrumentation collected by every solver run. Times are nanoseconds
+// from a monotonic clock; renderNs is filled in by whoever draws the result.
+struct SearchStats {
+    long long setupNs = 0;          // allocating and clearing visited/parent/frontier
+    long long searchNs = 0;         // search loop only
+    long long reconstructNs = 0;    // walking parent links back to the start
+    long long renderNs = 0;         // drawing the result (set by the view)
+    long long nodesExpanded = 0;    // cells popped from the frontier
+    long long peakFrontier = 0;     // largest queue/stack size seen
+    long long neighborChecks = 0;   // open neighbours examined while expanding
+    long long bytesAllocated = 0;   // peak bytes held by the solver's containers
+};
+
 struct PathResult {
-    std::vector<std::pair<int, int>> path;
-    std::vector<std::pair<int, int>> explored;  // Cells visited during search
+    std::pmr::vector<std::pair<int, int>> path;
+    std::pmr::vector<std::pair<int, int>> explored;  // Cells visited during search
     int stepsCount = 0;
     bool found = false;
+    long long totalCost = 0;   // sum of Maze weights entered along path (path cells - 1 if unweighted)
+    SearchStats stats;
+
+    explicit PathResult(std::pmr::memory_resource* resource = MemoryTracker::resource(MemorySubsystem::PathResult))
+        : path(resource), explored(resource) {}
+};
+
+enum class Algorithm { BFS, DFS, Dijkstra };
+
+// Priority queue behind solveDijkstra; Binary is a plain binary heap, kept for comparison
+enum class PriorityQueueKind { Radix, Binary };
+
+struct AlgorithmInfo {
+    Algorithm id;
+    const char* name;
+};
+
+// Live view of a running search, polled from another thread. While one is
+// attached the solver reserves explored up front, so the published prefix
+// [0, exploredCount) never moves and can be read as the search runs.
+// Setting stop makes the solver give up at its next publish (every 64
+// expansions) and return with found false.
+struct SearchProgress {
+    std::atomic<const std::pair<int, int>*> explored{nullptr};
+    std::atomic<long long> exploredCount{0};
+    std::atomic<long long> nodesExpanded{0};
+    std::atomic<bool> stop{false};
 };
 
+// Solvers index visited/parent/distance arrays and read wall masks in the
+// maze's cell layout (Maze::setCellLayout); results are (x, y) either way.
 class PathFinder {
 private:
+    struct Neighbor {
+        int x, y;
+        int cell;   // index in the maze's cell layout
+    };
+
     const Maze* maze;
     int startX, startY, endX, endY;
-    
+    SearchProgress* progress;
+    std::pmr::memory_resource* scratchResource;
+    std::pmr::memory_resource* resultResource;
+    const CellLayout* layout;   // the maze's, bound at the start of each solve
+    const uint8_t* masks;
+
     bool isValid(int x, int y) const;
-    std::vector<std::pair<int, int>> getNeighbors(int x, int y) const;
-    
+    void bindLayout();
+    // Fills out[] with open neighbors (top, right, bottom, left order) and
+    // returns how many there are; no allocation per call
+    int getNeighbors(int x, int y, int cell, Neighbor out[4]) const;
+    void reconstructPath(PathResult& result, const std::pmr::vector<int>& parent) const;
+    template <typename Queue>
+    void runDijkstra(PathResult& result, Queue& queue, std::pmr::memory_resource* scratch);
+    void beginProgress(PathResult& result, size_t cellCount) const;
+    // Publishes and returns whether the watcher asked the search to stop
+    bool publishProgress(const PathResult& result) const;
+
 public:
     PathFinder(const Maze* m, int sx, int sy, int ex, int ey);
-    
+
     // BFS - finds shortest path
     PathResult solveBFS();
-    
+
     // DFS - explores depth-first
     PathResult solveDFS();
+
+    // Dijkstra - cheapest path under the maze's cell weights (equals BFS on
+    // an unweighted maze); explored lists cells in the order they settle
+    PathResult solveDijkstra(PriorityQueueKind queue = PriorityQueueKind::Radix);
+
+    // Every registered algorithm, in display order
+    static const std::vector<AlgorithmInfo>& algorithms();
+    static bool findAlgorithm(const std::string& name, Algorithm& out);
+    PathResult solve(Algorithm algorithm);
+
+    // Publish progress to another thread while solving (nullptr to detach)
+    void setProgress(SearchProgress* p) { progress = p; }
+
+    // Where visited/parent/frontier live during a solve (nullptr = tracked heap)
+    void setScratchResource(std::pmr::memory_resource* r);
+    // Where the returned PathResult keeps path/explored (nullptr = tracked heap).
+    // A result backed by an arena is only valid until that arena is reset.
+    void setResultResource(std::pmr::memory_resource* r);
 };
 
-#endif // PATHFINDER_H
\ No newline at end of file
+#endif // PATHFINDER_H
@@ -0,0 +1,91 @@
+#ifndef RADIXHEAP_H
+#define RADIXHEAP_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// Monotone radix heap for integer keys (Ahuja, Mehlhorn, Orlin, Tarjan).
+// Keys pushed must never be smaller than the last key popped, which holds
+// for Dijkstra with non-negative weights. Bucket i holds keys whose highest
+// bit differing from the last popped key is bit i - 1, so each key moves
+// down at most 64 times over its lifetime and push is O(1).
+template <typename Value>
+class RadixHeap {
+private:
+    using Entry = std::pair<uint64_t, Value>;
+
+    std::pmr::vector<Entry> buckets[65];
+    uint64_t last;
+    size_t count;
+
+    static int highestBit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(x);
+#else
+        int bit = 0;
+        while (x >>= 1) bit++;
+        return bit;
+#endif
+    }
+
+    int bucketFor(uint64_t key) const {
+        return key == last ? 0 : highestBit(key ^ last) + 1;
+    }
+
+    // Refill bucket 0 from the first non-empty bucket; with count > 0 one
+    // exists, so the scan stays inside buckets
+    void pull() {
+        if (!buckets[0].empty() || count == 0) return;
+
+        int i = 1;
+        while (buckets[i].empty()) i++;
+
+        uint64_t smallest = buckets[i][0].first;
+        for (const Entry& e : buckets[i]) {
+            if (e.first < smallest) smallest = e.first;
+        }
+        last = smallest;
+
+        // Every entry lands in a lower bucket relative to the new minimum
+        for (Entry& e : buckets[i]) {
+            buckets[bucketFor(e.first)].push_back(std::move(e));
+        }
+        buckets[i].clear();
+    }
+
+public:
+    explicit RadixHeap(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : last(0), count(0) {
+        for (auto& bucket : buckets) {
+            bucket = std::pmr::vector<Entry>(resource);
+        }
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void push(uint64_t key, Value value) {
+        buckets[bucketFor(key)].emplace_back(key, std::move(value));
+        count++;
+    }
+
+    // Smallest entry; the heap must not be empty
+    Entry pop() {
+        pull();
+        Entry top = std::move(buckets[0].back());
+        buckets[0].pop_back();
+        count--;
+        return top;
+    }
+
+    // Capacity held across all buckets, in bytes
+    size_t heldBytes() const {
+        size_t bytes = 0;
+        for (const auto& bucket : buckets) bytes += bucket.capacity() * sizeof(Entry);
+        return bytes;
+    }
+};
+
+#endif // RADIXHEAP_H
@@ -0,0 +1,93 @@
+#include "solutioncache.h"
+#include "tracer.h"
+
+size_t SolutionKeyHash::operator()(const SolutionKey& key) const {
+    // The fingerprint is already well mixed; fold the small fields into it
+    uint64_t h = key.fingerprint;
+    uint64_t fields[5] = {
+        static_cast<uint64_t>(key.algorithm),
+        static_cast<uint64_t>(static_cast<uint32_t>(key.startX)),
+        static_cast<uint64_t>(static_cast<uint32_t>(key.startY)),
+        static_cast<uint64_t>(static_cast<uint32_t>(key.endX)),
+        static_cast<uint64_t>(static_cast<uint32_t>(key.endY))
+    };
+    for (uint64_t field : fields) {
+        h = (h ^ field) * 0x100000001b3ULL;
+    }
+    return static_cast<size_t>(h ^ (h >> 32));
+}
+
+SolutionCache::SolutionCache(size_t entries)
+    : capacity(entries), hits(0), misses(0), evictions(0) {}
+
+std::shared_ptr<const PathResult> SolutionCache::find(const SolutionKey& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    order.splice(order.begin(), order, it->second);
+    return it->second->second;
+}
+
+void SolutionCache::insert(const SolutionKey& key, std::shared_ptr<const PathResult> result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->second = std::move(result);
+        order.splice(order.begin(), order, it->second);
+        return;
+    }
+    order.emplace_front(key, std::move(result));
+    index[key] = order.begin();
+    evictOverflow();
+}
+
+void SolutionCache::evictOverflow() {
+    while (order.size() > capacity) {
+        index.erase(order.back().first);
+        order.pop_back();
+        evictions++;
+    }
+}
+
+std::shared_ptr<const PathResult> SolutionCache::solve(const Maze& maze, Algorithm algorithm,
+                                                       int sx, int sy, int ex, int ey, bool* wasHit) {
+    SolutionKey key{maze.fingerprint(), algorithm, sx, sy, ex, ey};
+    std::shared_ptr<const PathResult> cached = find(key);
+    if (wasHit) *wasHit = cached != nullptr;
+    if (cached) return cached;
+
+    // Solve outside the lock; two threads missing together both solve,
+    // and the second insert simply refreshes the entry
+    TRACE_SCOPE("cache", "solve on miss");
+    PathFinder pf(&maze, sx, sy, ex, ey);
+    auto result = std::make_shared<const PathResult>(pf.solve(algorithm));
+    insert(key, result);
+    return result;
+}
+
+void SolutionCache::setCapacity(size_t entries) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = entries;
+    evictOverflow();
+}
+
+void SolutionCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    order.clear();
+    index.clear();
+}
+
+CacheStats SolutionCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    CacheStats s;
+    s.hits = hits;
+    s.misses = misses;
+    s.evictions = evictions;
+    s.entries = static_cast<long long>(order.size());
+    s.capacity = static_cast<long long>(capacity);
+    return s;
+}
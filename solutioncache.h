@@ -0,0 +1,68 @@
+#ifndef SOLUTIONCACHE_H
+#define SOLUTIONCACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "maze.h"
+#include "pathfinder.h"
+
+struct SolutionKey {
+    uint64_t fingerprint;   // Maze::fingerprint()
+    Algorithm algorithm;
+    int startX, startY, endX, endY;
+
+    bool operator==(const SolutionKey& other) const {
+        return fingerprint == other.fingerprint && algorithm == other.algorithm
+            && startX == other.startX && startY == other.startY
+            && endX == other.endX && endY == other.endY;
+    }
+};
+
+struct SolutionKeyHash {
+    size_t operator()(const SolutionKey& key) const;
+};
+
+struct CacheStats {
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+    long long entries = 0;
+    long long capacity = 0;
+};
+
+// Bounded LRU cache of solver results. Entries are shared and immutable,
+// so a hit hands back the same PathResult without copying it. Keys carry
+// the maze fingerprint, so edits to the maze simply stop matching old
+// entries. All members are safe to call from several threads.
+class SolutionCache {
+private:
+    using Entry = std::pair<SolutionKey, std::shared_ptr<const PathResult>>;
+
+    size_t capacity;
+    std::list<Entry> order;   // most recently used first
+    std::unordered_map<SolutionKey, std::list<Entry>::iterator, SolutionKeyHash> index;
+    mutable std::mutex mutex;
+    long long hits, misses, evictions;
+
+    void evictOverflow();
+
+public:
+    explicit SolutionCache(size_t capacity = 64);
+
+    // nullptr on a miss; a hit becomes the most recently used entry
+    std::shared_ptr<const PathResult> find(const SolutionKey& key);
+    void insert(const SolutionKey& key, std::shared_ptr<const PathResult> result);
+
+    // Cached result, or solve, store and return it. wasHit is optional.
+    std::shared_ptr<const PathResult> solve(const Maze& maze, Algorithm algorithm,
+                                            int sx, int sy, int ex, int ey, bool* wasHit = nullptr);
+
+    void setCapacity(size_t entries);
+    void clear();
+    CacheStats stats() const;
+};
+
+#endif // SOLUTIONCACHE_H
@@ -0,0 +1,111 @@
+#include "solverrace.h"
+#include <chrono>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Pin the calling thread to one core; returns false where unsupported
+bool pinToCore(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// Cores this process may run on, in ascending order
+std::vector<int> allowedCores() {
+    std::vector<int> cores;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) cores.push_back(cpu);
+        }
+    }
+#endif
+    return cores;
+}
+
+} // namespace
+
+SolverRace::SolverRace(const Maze* m, int sx, int sy, int ex, int ey)
+    : maze(m), startX(sx), startY(sy), endX(ex), endY(ey), ready(0), go(false) {
+    for (const AlgorithmInfo& info : PathFinder::algorithms()) {
+        auto lane = std::make_unique<RaceLane>();
+        lane->algorithm = info;
+        lanes.push_back(std::move(lane));
+    }
+}
+
+SolverRace::~SolverRace() {
+    cancel();
+    wait();
+}
+
+void SolverRace::start() {
+    if (!threads.empty()) return;
+
+    // Sharing a core would serialize the lanes it holds, so pin only when
+    // every lane can have one of the cores we are allowed to use
+    std::vector<int> cores = allowedCores();
+    bool pin = cores.size() >= lanes.size();
+
+    for (size_t i = 0; i < lanes.size(); i++) {
+        int cpu = pin ? cores[i] : -1;
+        threads.emplace_back(&SolverRace::runLane, this, std::ref(*lanes[i]), cpu);
+    }
+
+    // Release everyone at once, after all lanes are pinned and waiting
+    while (ready.load(std::memory_order_acquire) < static_cast<int>(lanes.size())) {
+        std::this_thread::yield();
+    }
+    go.store(true, std::memory_order_release);
+}
+
+void SolverRace::runLane(RaceLane& lane, int cpu) {
+    lane.cpu = cpu >= 0 && pinToCore(cpu) ? cpu : -1;
+
+    PathFinder pf(maze, startX, startY, endX, endY);
+    pf.setProgress(&lane.progress);
+
+    ready.fetch_add(1, std::memory_order_acq_rel);
+    while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    lane.result = pf.solve(lane.algorithm.id);
+    lane.wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    lane.finished.store(true, std::memory_order_release);
+}
+
+void SolverRace::wait() {
+    for (std::thread& t : threads) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void SolverRace::cancel() {
+    for (const auto& lane : lanes) {
+        lane->progress.stop.store(true, std::memory_order_relaxed);
+    }
+}
+
+bool SolverRace::isFinished() const {
+    for (const auto& lane : lanes) {
+        if (!lane->finished.load(std::memory_order_acquire)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+#ifndef SOLVERRACE_H
+#define SOLVERRACE_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "maze.h"
+#include "pathfinder.h"
+
+// One competitor in a race. Fields other than progress and finished belong
+// to the solver thread until finished reads true.
+struct RaceLane {
+    AlgorithmInfo algorithm;
+    SearchProgress progress;
+    std::atomic<bool> finished{false};
+    PathResult result;
+    long long wallNs = 0;   // barrier release to solver return
+    int cpu = -1;           // core the thread was pinned to, -1 if unpinned
+};
+
+// Runs every registered PathFinder algorithm at once, each on its own
+// thread, against one shared read-only Maze. Threads are pinned to
+// distinct cores from the process's allowed set when it has one per lane,
+// and left to the scheduler otherwise. A start barrier releases all threads
+// together so their timings overlap. Destroying a race cancels it first.
+class SolverRace {
+private:
+    const Maze* maze;
+    int startX, startY, endX, endY;
+    std::vector<std::unique_ptr<RaceLane>> lanes;
+    std::vector<std::thread> threads;
+    std::atomic<int> ready;
+    std::atomic<bool> go;
+
+    void runLane(RaceLane& lane, int cpu);
+
+public:
+    SolverRace(const Maze* m, int sx, int sy, int ex, int ey);
+    ~SolverRace();
+
+    SolverRace(const SolverRace&) = delete;
+    SolverRace& operator=(const SolverRace&) = delete;
+
+    void start();
+    void wait();
+    // Ask every lane to stop; they return unfinished within 64 expansions
+    void cancel();
+    bool isFinished() const;
+
+    int laneCount() const { return static_cast<int>(lanes.size()); }
+    const RaceLane& lane(int i) const { return *lanes[i]; }
+};
+
+#endif // SOLVERRACE_H
@@ -0,0 +1,122 @@
+#include "tracer.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* category;
+    const char* name;
+    int64_t beginNs;
+    int64_t endNs;
+};
+
+// Single-producer ring: only the owning thread writes events and head.
+// A reader loads head with acquire and then sees every event before it.
+struct ThreadBuffer {
+    static const size_t Capacity = 1 << 16;   // power of two
+
+    int tid;
+    std::unique_ptr<TraceEvent[]> events;
+    std::atomic<uint64_t> head{0};
+
+    explicit ThreadBuffer(int id) : tid(id), events(new TraceEvent[Capacity]) {}
+};
+
+// Buffers outlive their threads, so spans from finished workers still dump
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>>& registry() {
+    static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    return buffers;
+}
+
+ThreadBuffer* threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        // Locked once per thread, on its first span
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto& buffers = registry();
+        buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<int>(buffers.size()) + 1));
+        buffer = buffers.back().get();
+    }
+    return buffer;
+}
+
+const std::chrono::steady_clock::time_point processStart = std::chrono::steady_clock::now();
+
+void writeJsonString(FILE* out, const char* text) {
+    std::fputc('"', out);
+    for (const char* p = text; *p; p++) {
+        if (*p == '"' || *p == '\\') std::fputc('\\', out);
+        std::fputc(*p, out);
+    }
+    std::fputc('"', out);
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::active{false};
+
+void Tracer::setEnabled(bool on) {
+    active.store(on, std::memory_order_relaxed);
+}
+
+int64_t Tracer::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - processStart).count();
+}
+
+void Tracer::record(const char* category, const char* name, int64_t beginNs, int64_t endNs) {
+    ThreadBuffer* buffer = threadBuffer();
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    buffer->events[head & (ThreadBuffer::Capacity - 1)] = {category, name, beginNs, endNs};
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+bool Tracer::writeChromeJson(const std::string& filename, std::string* error) {
+    FILE* out = std::fopen(filename.c_str(), "w");
+    if (!out) {
+        if (error) *error = "Cannot open " + filename + " for writing";
+        return false;
+    }
+
+    std::fputs("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n", out);
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& buffer : registry()) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t count = head < ThreadBuffer::Capacity ? head : ThreadBuffer::Capacity;
+
+        std::fprintf(out, "%s{\"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"name\": \"thread_name\", "
+                          "\"args\": {\"name\": \"thread %d\"}}",
+                     first ? "" : ",\n", buffer->tid, buffer->tid);
+        first = false;
+
+        for (uint64_t i = head - count; i < head; i++) {
+            const TraceEvent& e = buffer->events[i & (ThreadBuffer::Capacity - 1)];
+            // Complete ("X") events; timestamps are in microseconds
+            std::fputs(",\n{\"ph\": \"X\", \"pid\": 1, \"name\": ", out);
+            writeJsonString(out, e.name);
+            std::fputs(", \"cat\": ", out);
+            writeJsonString(out, e.category);
+            std::fprintf(out, ", \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                         buffer->tid, e.beginNs / 1000.0, (e.endNs - e.beginNs) / 1000.0);
+        }
+    }
+
+    std::fputs("\n]}\n", out);
+    bool ok = std::fclose(out) == 0;
+    if (!ok && error) *error = "Write failed for " + filename;
+    return ok;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& buffer : registry()) {
+        buffer->head.store(0, std::memory_order_release);
+    }
+}
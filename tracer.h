@@ -0,0 +1,61 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped timeline spans, dumped as Chrome trace-event JSON (open the file in
+// ui.perfetto.dev or chrome://tracing). Each thread records into its own
+// fixed-size ring buffer without locks; once a buffer wraps, the oldest spans
+// are overwritten. Recording is off until Tracer::setEnabled(true). While it
+// is off, a span costs one relaxed atomic load. Configuring with
+// -DMAZE_TRACING=OFF removes the spans from the build entirely.
+class Tracer {
+private:
+    static std::atomic<bool> active;
+
+public:
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on);
+
+    // Nanoseconds on a monotonic clock, relative to process start
+    static int64_t now();
+
+    // name and category must be string literals (only the pointers are kept)
+    static void record(const char* category, const char* name, int64_t beginNs, int64_t endNs);
+
+    // Write every buffered span; call once the traced work has finished
+    static bool writeChromeJson(const std::string& filename, std::string* error = nullptr);
+    // Drop buffered spans; only while no thread is recording
+    static void clear();
+};
+
+class TraceSpan {
+private:
+    const char* category;
+    const char* name;
+    int64_t begin;   // -1 when tracing was off at construction
+
+public:
+    TraceSpan(const char* c, const char* n)
+        : category(c), name(n), begin(Tracer::enabled() ? Tracer::now() : -1) {}
+    ~TraceSpan() {
+        if (begin >= 0) Tracer::record(category, name, begin, Tracer::now());
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if MAZE_TRACING
+// Times the rest of the enclosing scope
+#define TRACE_SCOPE(category, name) TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(category, name)
+#else
+#define TRACE_SCOPE(category, name) ((void)0)
+#endif
+
+#endif // TRACER_H
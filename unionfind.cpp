@@ -1,6 +1,9 @@
 #include "unionfind.h"
+#include <algorithm>
+#include <utility>
 
-UnionFind::UnionFind(int n) {
+UnionFind::UnionFind(int n, std::pmr::memory_resource* resource)
+    : parent(resource), rank(resource) {
     parent.resize(n);
     rank.resize(n, 0);
     
@@ -42,4 +45,58 @@ bool UnionFind::unite(int x, int y) {
 
 bool UnionFind::connected(int x, int y) {
     return find(x) == find(y);
-}
\ No newline at end of file
+}
+
+RollbackUnionFind::RollbackUnionFind(int n, std::pmr::memory_resource* resource)
+    : parent(resource), rank(resource), history(resource), sets(n) {
+    parent.resize(n);
+    rank.resize(n, 0);
+    for (int i = 0; i < n; i++) {
+        parent[i] = i;
+    }
+}
+
+int RollbackUnionFind::find(int x) const {
+    // Union by rank keeps every tree O(log n) deep
+    while (parent[x] != x) {
+        x = parent[x];
+    }
+    return x;
+}
+
+bool RollbackUnionFind::unite(int x, int y) {
+    int rootX = find(x);
+    int rootY = find(y);
+    if (rootX == rootY) {
+        return false;
+    }
+
+    if (rank[rootX] < rank[rootY]) {
+        std::swap(rootX, rootY);
+    }
+    bool raised = rank[rootX] == rank[rootY];
+    parent[rootY] = rootX;
+    if (raised) rank[rootX]++;
+    history.push_back({rootY, rootX, raised});
+    sets--;
+    return true;
+}
+
+void RollbackUnionFind::rollback(size_t snapshot) {
+    while (history.size() > snapshot) {
+        const Change& change = history.back();
+        parent[change.child] = change.child;
+        if (change.rankRaised) rank[change.parent]--;
+        history.pop_back();
+        sets++;
+    }
+}
+
+void RollbackUnionFind::reset() {
+    for (size_t i = 0; i < parent.size(); i++) {
+        parent[i] = static_cast<int>(i);
+    }
+    std::fill(rank.begin(), rank.end(), 0);
+    history.clear();
+    sets = static_cast<int>(parent.size());
+}
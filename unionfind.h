@@ -1,15 +1,17 @@
 #ifndef UNIONFIND_H 
 #define UNIONFIND_H 
 
+#include <memory_resource>
 #include <vector>
+#include "memorytracker.h"
 
 class UnionFind {
 private:
-    std::vector<int> parent;
-    std::vector<int> rank;
+    std::pmr::vector<int> parent;
+    std::pmr::vector<int> rank;
 
 public:
-    UnionFind(int n);
+    UnionFind(int n, std::pmr::memory_resource* resource = MemoryTracker::resource(MemorySubsystem::UnionFind));
     
     // Find the root of element x with path compression
     int find(int x);
@@ -21,4 +23,35 @@ public:
     bool connected(int x, int y);
 };
 
+// Union by rank without path compression, so every union can be undone.
+// find() is O(log n) and never writes, which keeps queries const and lets
+// rollback() restore any earlier state in O(1) per undone union.
+class RollbackUnionFind {
+private:
+    struct Change {
+        int child;          // root that was attached
+        int parent;         // root it was attached under
+        bool rankRaised;    // parent's rank went up by one
+    };
+
+    std::pmr::vector<int> parent;
+    std::pmr::vector<unsigned char> rank;
+    std::pmr::vector<Change> history;
+    int sets;
+
+public:
+    RollbackUnionFind(int n, std::pmr::memory_resource* resource = MemoryTracker::resource(MemorySubsystem::UnionFind));
+
+    int find(int x) const;
+    bool unite(int x, int y);
+    bool connected(int x, int y) const { return find(x) == find(y); }
+    int components() const { return sets; }
+
+    // Number of unions so far; pass it to rollback() to return to this state
+    size_t snapshot() const { return history.size(); }
+    void rollback(size_t snapshot);
+    // Back to n singletons, keeping the allocations
+    void reset();
+};
+
 #endif // UNIONFIND_H
\ No newline at end of file